@@ -0,0 +1,189 @@
+/* micro-benchmark: Dd primitives of dmc on synthetic diagrams, for CUDD (linear, log10) and Sylvan (double, GMP) */
+
+/* inclusions =============================================================== */
+
+#include "../src/dmc.hh"
+
+/* externs ================================================================== */
+
+extern "C" void cache_clear(); // sylvan_cache.h, which is only included via sylvan_int.h
+
+/* consts =================================================================== */
+
+const Int PAIR_COUNT = 5; // operand pairs per (backend, shape, operation)
+const Int CHAIN_WINDOW = 6; // vars per clause in chain shape
+const Float BENCH_MAX_MEM = 4e3; // in MB
+const vector<pair<string, Int>> SHAPES = { // (shape, var count)
+  {"full", 10}, // product of independent weighted literals: 2^n distinct terminals
+  {"full", 14},
+  {"chain", 64}, // product of random OR/XOR clauses over overlapping windows: 0-1 values, bounded width
+  {"chain", 256}
+};
+
+/* classes ================================================================== */
+
+class Backend {
+public:
+  string name;
+  string ddPackage;
+  bool logCounting;
+  bool multiplePrecision;
+};
+
+class Operation {
+public:
+  string name;
+  bool binaryFlag; // else unary
+  bool cuddFlag; // CUDD only
+  bool logFlag; // log10 domain only
+  bool zeroOneFlag; // needs 0-1 DDs
+  std::function<Dd(const Dd&, const Dd&, Int, const Cudd*)> apply; // (left, right, middle DD var, mgr)
+};
+
+/* global vars ============================================================== */
+
+vector<Int> ddVarToCnfVarMap; // DD var i is CNF var i + 1
+Map<Int, Number> literalWeights;
+vector<pair<Int, Dd>> unusedMaximizationStack;
+
+/* global functions ========================================================= */
+
+void setBackend(const Backend& backend) { // global vars read by Dd
+  ddPackage = backend.ddPackage;
+  logCounting = backend.logCounting;
+  multiplePrecision = backend.multiplePrecision;
+}
+
+void flushCache(const Cudd* mgr) { // cold start for next operation
+  if (ddPackage == CUDD) {
+    cuddCacheFlush(mgr->getManager());
+  }
+  else {
+    cache_clear();
+  }
+}
+
+Dd getFullDd(Int varCount, std::mt19937& generator, const Cudd* mgr) {
+  std::uniform_real_distribution<Float> distribution(0.1, 0.9);
+  Dd dd = Dd::getOneDd(mgr);
+  for (Int ddVar = varCount - 1; ddVar >= 0; ddVar--) {
+    Float weight = distribution(generator);
+    Dd factor = Dd::getVarDd(ddVar, true, mgr).getProduct(Dd::getConstDd(Number(to_string(weight)), mgr)).getSum(Dd::getVarDd(ddVar, false, mgr).getProduct(Dd::getConstDd(Number(to_string(1 - weight)), mgr))); // strings also suit GMP
+    dd = dd.getProduct(factor);
+  }
+  return dd;
+}
+
+Dd getChainDd(Int varCount, std::mt19937& generator, const Cudd* mgr) {
+  for (Int ddVar = 0; ddVar < varCount; ddVar++) { // creates CUDD vars in index order
+    Dd::getVarLevel(ddVar, mgr);
+  }
+  Dd dd = Dd::getOneDd(mgr);
+  for (Int firstVar = 0; firstVar + CHAIN_WINDOW <= varCount; firstVar += CHAIN_WINDOW / 2) {
+    vector<pair<Int, bool>> ddLiterals; // from bottom level up
+    for (Int ddVar = firstVar + CHAIN_WINDOW - 1; ddVar >= firstVar; ddVar--) {
+      ddLiterals.push_back({ddVar, static_cast<bool>(generator() % 2)});
+    }
+    dd = dd.getProduct(Dd::getClauseDd(ddLiterals, generator() % 2, false, mgr));
+  }
+  return dd;
+}
+
+Dd getShapeDd(string shape, Int varCount, std::mt19937& generator, const Cudd* mgr) {
+  if (shape == "full") {
+    return getFullDd(varCount, generator, mgr);
+  }
+  return getChainDd(varCount, generator, mgr);
+}
+
+vector<Operation> getOperations() {
+  return {
+    {"getProduct", true, false, false, false, [](const Dd& left, const Dd& right, Int ddVar, const Cudd* mgr) { return left.getProduct(right); }},
+    {"getSum", true, false, false, false, [](const Dd& left, const Dd& right, Int ddVar, const Cudd* mgr) { return left.getSum(right); }},
+    {"getMax", true, false, false, false, [](const Dd& left, const Dd& right, Int ddVar, const Cudd* mgr) { return left.getMax(right); }},
+    {"getXor", true, true, false, true, [](const Dd& left, const Dd& right, Int ddVar, const Cudd* mgr) { return left.getXor(right); }},
+    {"getAbstraction(sum)", false, false, false, false, [](const Dd& left, const Dd& right, Int ddVar, const Cudd* mgr) {
+      return left.getAbstraction(ddVar, ddVarToCnfVarMap, literalWeights, Assignment(), true, unusedMaximizationStack, mgr);
+    }},
+    {"getAbstraction(max)", false, false, false, false, [](const Dd& left, const Dd& right, Int ddVar, const Cudd* mgr) {
+      return left.getAbstraction(ddVar, ddVarToCnfVarMap, literalWeights, Assignment(), false, unusedMaximizationStack, mgr);
+    }},
+    {"getComposition", false, false, false, false, [](const Dd& left, const Dd& right, Int ddVar, const Cudd* mgr) { return left.getComposition(ddVar, true, mgr); }},
+    {"getPrunedDd", false, true, true, false, [](const Dd& left, const Dd& right, Int ddVar, const Cudd* mgr) {
+      return left.getPrunedDd(cuddV(left.cuadd.FindMax().getNode()) - 1, mgr); // drops terminals below a tenth of max
+    }}
+  };
+}
+
+Float timeOperation(const Operation& operation, const Dd& left, const Dd& right, Int ddVar, const Cudd* mgr, bool warmFlag) { // in seconds
+  if (warmFlag) { // fills operation cache with same operands
+    operation.apply(left, right, ddVar, mgr);
+  }
+  else {
+    flushCache(mgr);
+  }
+  TimePoint startPoint = util::getTimePoint();
+  Dd result = operation.apply(left, right, ddVar, mgr);
+  return std::chrono::duration<Float>(util::getTimePoint() - startPoint).count(); // finer than util::getDuration
+}
+
+void runBackend(const Backend& backend) {
+  setBackend(backend);
+  const Cudd* mgr = backend.ddPackage == CUDD ? Dd::newMgr(BENCH_MAX_MEM) : nullptr;
+
+  for (const auto& [shape, varCount] : SHAPES) {
+    for (const Operation& operation : getOperations()) {
+      if ((operation.cuddFlag && backend.ddPackage != CUDD) || (operation.logFlag && !backend.logCounting) || (operation.zeroOneFlag && shape != "chain")) {
+        continue;
+      }
+
+      std::mt19937 generator(0); // same operands for every operation
+      Int ddVar = varCount / 2;
+      Float inputNodeCount = 0;
+      Float coldSeconds = 0;
+      Float warmSeconds = 0;
+      for (Int i = 0; i < PAIR_COUNT; i++) {
+        Dd left = getShapeDd(shape, varCount, generator, mgr);
+        Dd right = getShapeDd(shape, varCount, generator, mgr);
+        inputNodeCount += left.getNodeCount() + (operation.binaryFlag ? right.getNodeCount() : 0);
+        coldSeconds += timeOperation(operation, left, right, ddVar, mgr, false);
+        warmSeconds += timeOperation(operation, left, right, ddVar, mgr, true);
+      }
+
+      cout << backend.name << "," << shape << "," << varCount << "," << operation.name << "," << static_cast<Int>(inputNodeCount / PAIR_COUNT);
+      cout << "," << coldSeconds / PAIR_COUNT * 1e9 << "," << warmSeconds / PAIR_COUNT * 1e9;
+      cout << "," << inputNodeCount / coldSeconds << "," << inputNodeCount / warmSeconds << "\n";
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  memSensitivity = BENCH_MAX_MEM; // keeps CUDD from printing memory increases
+  for (Int ddVar = 0; ddVar < 1 << 10; ddVar++) {
+    ddVarToCnfVarMap.push_back(ddVar + 1);
+    literalWeights[ddVar + 1] = Number("0.3");
+    literalWeights[-ddVar - 1] = Number("0.7");
+  }
+
+  lace_init(1, 0);
+  lace_startup(0, NULL, NULL);
+  sylvan::sylvan_set_limits(BENCH_MAX_MEM * MEGA, 1, 10);
+  sylvan::sylvan_init_package();
+  sylvan::sylvan_init_mtbdd();
+  sylvan::gmp_init();
+
+  cout << std::fixed;
+  cout.precision(1);
+  cout << "backend,shape,vars,operation,inputNodes,coldNsPerOp,warmNsPerOp,coldNodesPerSecond,warmNodesPerSecond\n";
+  for (const Backend& backend : vector<Backend>{
+    {"CUDD", CUDD, false, false},
+    {"CUDD_LOG10", CUDD, true, false},
+    {"SYLVAN_DOUBLE", SYLVAN, false, false},
+    {"SYLVAN_GMP", SYLVAN, false, true}
+  }) {
+    runBackend(backend);
+  }
+
+  sylvan::sylvan_quit();
+  lace_exit();
+}
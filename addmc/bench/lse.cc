@@ -0,0 +1,108 @@
+/* micro-benchmark: Cudd_addLogSumExp (library kernel) vs exact log10/exp10 kernel, applied to log ADDs */
+
+/* inclusions =============================================================== */
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "cudd.h"
+#include "cuddInt.h"
+
+/* uses ===================================================================== */
+
+using std::cout;
+using std::setw;
+using std::vector;
+
+/* consts =================================================================== */
+
+const int VAR_COUNT = 14; // each operand has 2^VAR_COUNT distinct terminals
+const int PAIR_COUNT = 16;
+const double MAX_COEFFICIENT = 4; // log10 terminals are sums of coefficients in [-MAX_COEFFICIENT, MAX_COEFFICIENT]
+
+/* global functions ========================================================= */
+
+DdNode* exactLogSumExp(DdManager* dd, DdNode** f, DdNode** g) { // Cudd_addLogSumExp before table kernel
+  DdNode* F = *f;
+  DdNode* G = *g;
+  if (F == DD_MINUS_INFINITY(dd)) return G;
+  if (G == DD_MINUS_INFINITY(dd)) return F;
+  if (cuddIsConstant(F) && cuddIsConstant(G)) {
+    CUDD_VALUE_TYPE m = fmax(cuddV(F), cuddV(G));
+    return cuddUniqueConst(dd, log10(exp10(cuddV(F) - m) + exp10(cuddV(G) - m)) + m);
+  }
+  if (F > G) {
+    *f = G;
+    *g = F;
+  }
+  return NULL;
+}
+
+DdNode* getRandomLogAdd(DdManager* mgr, std::mt19937& generator) { // sum of var_i * c_i over log10 values
+  std::uniform_real_distribution<double> distribution(-MAX_COEFFICIENT, MAX_COEFFICIENT);
+  DdNode* sum = Cudd_ReadZero(mgr);
+  Cudd_Ref(sum);
+  for (int i = 0; i < VAR_COUNT; i++) {
+    DdNode* coefficient = Cudd_addConst(mgr, distribution(generator));
+    Cudd_Ref(coefficient);
+    DdNode* var = Cudd_addIthVar(mgr, i);
+    Cudd_Ref(var);
+    DdNode* term = Cudd_addIte(mgr, var, coefficient, Cudd_ReadZero(mgr));
+    Cudd_Ref(term);
+    Cudd_RecursiveDeref(mgr, var);
+    DdNode* newSum = Cudd_addApply(mgr, Cudd_addPlus, sum, term);
+    Cudd_Ref(newSum);
+    Cudd_RecursiveDeref(mgr, coefficient);
+    Cudd_RecursiveDeref(mgr, term);
+    Cudd_RecursiveDeref(mgr, sum);
+    sum = newSum;
+  }
+  return sum;
+}
+
+double timeApplies(DdManager* mgr, DD_AOP op, const vector<DdNode*>& leftAdds, const vector<DdNode*>& rightAdds, vector<DdNode*>& results) { // in seconds
+  auto startPoint = std::chrono::steady_clock::now();
+  for (int i = 0; i < PAIR_COUNT; i++) {
+    results.push_back(Cudd_addApply(mgr, op, leftAdds.at(i), rightAdds.at(i)));
+    Cudd_Ref(results.back());
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - startPoint).count();
+}
+
+int main() {
+  DdManager* mgr = Cudd_Init(VAR_COUNT, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+  std::mt19937 generator(0);
+
+  vector<DdNode*> leftAdds;
+  vector<DdNode*> rightAdds;
+  for (int i = 0; i < PAIR_COUNT; i++) {
+    leftAdds.push_back(getRandomLogAdd(mgr, generator));
+    rightAdds.push_back(getRandomLogAdd(mgr, generator));
+  }
+
+  vector<DdNode*> exactResults;
+  vector<DdNode*> libraryResults;
+  double exactSeconds = timeApplies(mgr, exactLogSumExp, leftAdds, rightAdds, exactResults);
+  double librarySeconds = timeApplies(mgr, Cudd_addLogSumExp, leftAdds, rightAdds, libraryResults);
+
+  double maxError = 0;
+  for (int i = 0; i < PAIR_COUNT; i++) {
+    DdNode* difference = Cudd_addApply(mgr, Cudd_addMinus, libraryResults.at(i), exactResults.at(i));
+    Cudd_Ref(difference);
+    maxError = fmax(maxError, fmax(cuddV(Cudd_addFindMax(mgr, difference)), -cuddV(Cudd_addFindMin(mgr, difference))));
+    Cudd_RecursiveDeref(mgr, difference);
+  }
+
+  long terminalPairCount = PAIR_COUNT * (1l << VAR_COUNT);
+  cout << "c terminal pairs per kernel      " << terminalPairCount << "\n";
+  cout << "c exact kernel seconds           " << exactSeconds << "\n";
+  cout << "c library kernel seconds         " << librarySeconds << "\n";
+  cout << "c speedup                        " << exactSeconds / librarySeconds << "\n";
+  cout << "c max abs error (log10)          " << maxError << "\n";
+
+  Cudd_Quit(mgr);
+}
@@ -0,0 +1,273 @@
+/* benchmark suite: generated instance families, timed parse/order/plan/execute stages, CSV results with peak RSS */
+
+/* inclusions =============================================================== */
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+
+#include "../src/common.hh"
+
+/* uses ===================================================================== */
+
+using std::ofstream;
+
+/* consts =================================================================== */
+
+const string INSTANCE_DIR = "bench/instances";
+const string DEFAULT_RESULT_FILE = "bench/results.csv";
+const vector<Int> ORDER_HEURISTICS = {MIN_FILL, MCS, LEX_P}; // stages timed in-process
+
+/* classes ================================================================== */
+
+class Instance {
+public:
+  string family;
+  string name;
+  string filePath;
+  vector<string> plannerOptions; // htb
+  vector<string> executorOptions; // dmc
+};
+
+class StageResult {
+public:
+  Float seconds = 0; // wall clock
+  Int peakRssKilobytes = 0;
+  string value; // join-tree width for plan, log10 solution for execute
+};
+
+/* global functions ========================================================= */
+
+extern char** environ;
+
+Int getPeakRssKilobytes() { // of this process so far
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+string getFileValue(string filePath, string key) { // last word of first line starting with key
+  std::ifstream inputFileStream(filePath);
+  string line;
+  while (getline(inputFileStream, line)) {
+    if (line.starts_with(key)) {
+      return util::splitInputLine(line).back();
+    }
+  }
+  return "";
+}
+
+StageResult runProcess(const vector<string>& args, string inputPath, string outputPath) { // peak RSS from wait4
+  posix_spawn_file_actions_t fileActions;
+  posix_spawn_file_actions_init(&fileActions);
+  if (!inputPath.empty()) {
+    posix_spawn_file_actions_addopen(&fileActions, STDIN_FILENO, inputPath.c_str(), O_RDONLY, 0);
+  }
+  posix_spawn_file_actions_addopen(&fileActions, STDOUT_FILENO, outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  posix_spawn_file_actions_adddup2(&fileActions, STDOUT_FILENO, STDERR_FILENO);
+
+  vector<char*> argv;
+  for (const string& arg : args) {
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  StageResult result;
+  TimePoint startPoint = util::getTimePoint();
+  pid_t pid;
+  if (posix_spawn(&pid, argv.front(), &fileActions, nullptr, argv.data(), environ) != 0) {
+    throw MyError("cannot run ", args.front());
+  }
+  int status;
+  rusage usage;
+  wait4(pid, &status, 0, &usage);
+  result.seconds = util::getDuration(startPoint);
+  result.peakRssKilobytes = usage.ru_maxrss;
+  posix_spawn_file_actions_destroy(&fileActions);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    result.value = "FAILED";
+  }
+  return result;
+}
+
+void writeWeights(ofstream& outputFileStream, Int varCount, std::mt19937& generator, bool skewedFlag) {
+  std::uniform_real_distribution<Float> distribution(0.05, 0.95);
+  for (Int var = 1; var <= varCount; var++) {
+    if (skewedFlag) { // like examples/chain_n100_k10.xcnf
+      bool heavyFlag = generator() % 2;
+      outputFileStream << "c p weight " << var << " " << (heavyFlag ? 100 : 10) << " 0\n";
+      outputFileStream << "c p weight " << -var << " " << (heavyFlag ? 10 : 100) << " 0\n";
+    }
+    else {
+      Float weight = distribution(generator);
+      outputFileStream << "c p weight " << var << " " << weight << " 0\n";
+      outputFileStream << "c p weight " << -var << " " << 1 - weight << " 0\n";
+    }
+  }
+}
+
+void writeClause(ofstream& outputFileStream, const vector<Int>& vars, bool xorFlag, std::mt19937& generator) {
+  outputFileStream << (xorFlag ? "x" : "");
+  for (Int var : vars) {
+    outputFileStream << (xorFlag ? " " : "") << (generator() % 2 ? var : -var) << " ";
+  }
+  outputFileStream << "0\n";
+}
+
+Instance getChainInstance(Int varCount, Int windowSize, Int seed) { // clause i is random k-XOR or k-OR over vars i..i+k-1
+  Instance instance;
+  instance.family = "chain";
+  instance.name = "chain_n" + to_string(varCount) + "_k" + to_string(windowSize) + "_s" + to_string(seed);
+  instance.filePath = INSTANCE_DIR + "/" + instance.name + ".xcnf";
+  instance.executorOptions = {"--wc=1", "--er=1", "--lc=1"};
+
+  std::mt19937 generator(seed);
+  ofstream outputFileStream(instance.filePath);
+  outputFileStream << "p cnf " << varCount << " " << varCount - windowSize + 1 << "\n";
+  writeWeights(outputFileStream, varCount, generator, true);
+  for (Int firstVar = 1; firstVar + windowSize - 1 <= varCount; firstVar++) {
+    vector<Int> vars;
+    for (Int var = firstVar; var < firstVar + windowSize; var++) {
+      vars.push_back(var);
+    }
+    writeClause(outputFileStream, vars, generator() % 2, generator);
+  }
+  return instance;
+}
+
+Instance getGridInstance(Int sideLength, Int seed) { // cells are vars; each neighboring pair has a positive binary clause (vertex covers)
+  Instance instance;
+  instance.family = "grid";
+  instance.name = "grid_" + to_string(sideLength) + "x" + to_string(sideLength) + "_s" + to_string(seed);
+  instance.filePath = INSTANCE_DIR + "/" + instance.name + ".cnf";
+  instance.executorOptions = {"--wc=1", "--lc=1"};
+
+  std::mt19937 generator(seed);
+  ofstream outputFileStream(instance.filePath);
+  outputFileStream << "p cnf " << sideLength * sideLength << " " << 2 * sideLength * (sideLength - 1) << "\n";
+  writeWeights(outputFileStream, sideLength * sideLength, generator, false);
+  for (Int row = 0; row < sideLength; row++) {
+    for (Int column = 0; column < sideLength; column++) {
+      Int var = row * sideLength + column + 1;
+      if (column + 1 < sideLength) {
+        outputFileStream << var << " " << var + 1 << " 0\n";
+      }
+      if (row + 1 < sideLength) {
+        outputFileStream << var << " " << var + sideLength << " 0\n";
+      }
+    }
+  }
+  return instance;
+}
+
+Instance getProjectedInstance(Int varCount, Float clauseRatio, Int seed) { // random 3-CNF; first half of vars is shown
+  Instance instance;
+  instance.family = "projected";
+  instance.name = "projected_n" + to_string(varCount) + "_s" + to_string(seed);
+  instance.filePath = INSTANCE_DIR + "/" + instance.name + ".cnf";
+  instance.plannerOptions = {"--pc=1"};
+  instance.executorOptions = {"--wc=1", "--pc=1", "--lc=1"};
+
+  std::mt19937 generator(seed);
+  Int clauseCount = varCount * clauseRatio;
+  ofstream outputFileStream(instance.filePath);
+  outputFileStream << "p cnf " << varCount << " " << clauseCount << "\n";
+  writeWeights(outputFileStream, varCount, generator, false);
+  outputFileStream << "c p show";
+  for (Int var = 1; var <= varCount / 2; var++) {
+    outputFileStream << " " << var;
+  }
+  outputFileStream << " 0\n";
+  for (Int i = 0; i < clauseCount; i++) {
+    Set<Int> vars;
+    while (vars.size() < 3) {
+      vars.insert(generator() % varCount + 1);
+    }
+    writeClause(outputFileStream, util::getSortedNums(vars), false, generator);
+  }
+  return instance;
+}
+
+vector<Instance> getInstances() {
+  std::filesystem::create_directories(INSTANCE_DIR);
+  vector<Instance> instances;
+  for (Int varCount : {100, 200}) {
+    for (Int windowSize : {8, 10}) {
+      instances.push_back(getChainInstance(varCount, windowSize, 0));
+    }
+  }
+  for (Int sideLength : {6, 8, 10}) {
+    instances.push_back(getGridInstance(sideLength, 0));
+  }
+  for (Int varCount : {30, 40}) {
+    instances.push_back(getProjectedInstance(varCount, 2.5, 0));
+  }
+  return instances;
+}
+
+void addResult(ofstream& resultFileStream, const Instance& instance, string stage, const StageResult& result) {
+  resultFileStream << instance.family << "," << instance.name << "," << stage << "," << result.seconds << "," << result.peakRssKilobytes << "," << result.value << "\n";
+  cout << "c " << left << setw(28) << instance.name << setw(24) << stage;
+  cout << right << setw(12) << result.seconds << " s" << setw(12) << result.peakRssKilobytes << " KB  " << result.value << "\n";
+}
+
+void runInstance(ofstream& resultFileStream, const Instance& instance) {
+  projectedCounting = !instance.plannerOptions.empty(); // global vars read by Cnf
+  weightedCounting = true;
+
+  std::streambuf* coutBuffer = cout.rdbuf(nullptr); // Cnf prints stats
+  TimePoint parseStartPoint = util::getTimePoint();
+  Cnf cnf(instance.filePath);
+  Float parseSeconds = util::getDuration(parseStartPoint);
+  vector<pair<Int, Float>> orderSeconds;
+  for (Int heuristic : ORDER_HEURISTICS) {
+    TimePoint orderStartPoint = util::getTimePoint();
+    cnf.getCnfVarOrder(heuristic);
+    orderSeconds.push_back({heuristic, util::getDuration(orderStartPoint)});
+  }
+  cout.rdbuf(coutBuffer);
+
+  StageResult parseResult;
+  parseResult.seconds = parseSeconds;
+  parseResult.peakRssKilobytes = getPeakRssKilobytes();
+  parseResult.value = to_string(cnf.clauses.size());
+  addResult(resultFileStream, instance, "parse", parseResult);
+  for (const auto& [heuristic, seconds] : orderSeconds) {
+    StageResult orderResult;
+    orderResult.seconds = seconds;
+    orderResult.peakRssKilobytes = getPeakRssKilobytes();
+    addResult(resultFileStream, instance, "order_" + CNF_VAR_ORDER_HEURISTICS.at(heuristic), orderResult);
+  }
+
+  string joinTreePath = INSTANCE_DIR + "/" + instance.name + ".jt";
+  vector<string> plannerArgs = {"./htb", "--cf=" + instance.filePath};
+  plannerArgs.insert(plannerArgs.end(), instance.plannerOptions.begin(), instance.plannerOptions.end());
+  StageResult planResult = runProcess(plannerArgs, "", joinTreePath);
+  if (planResult.value.empty()) {
+    planResult.value = getFileValue(joinTreePath, "c joinTreeWidth");
+  }
+  addResult(resultFileStream, instance, "plan", planResult);
+
+  string outputPath = INSTANCE_DIR + "/" + instance.name + ".out";
+  vector<string> executorArgs = {"./dmc", "--cf=" + instance.filePath};
+  executorArgs.insert(executorArgs.end(), instance.executorOptions.begin(), instance.executorOptions.end());
+  StageResult executeResult = runProcess(executorArgs, joinTreePath, outputPath);
+  if (executeResult.value.empty()) {
+    executeResult.value = getFileValue(outputPath, "c s log10-estimate");
+  }
+  addResult(resultFileStream, instance, "execute", executeResult);
+}
+
+int main(int argc, char** argv) { // run from addmc/ after building htb and dmc; optional arg: result file
+  string resultFilePath = argc > 1 ? argv[1] : DEFAULT_RESULT_FILE;
+  ofstream resultFileStream(resultFilePath);
+  resultFileStream << "family,instance,stage,seconds,peakRssKilobytes,value\n";
+  resultFileStream.precision(6);
+  cout.precision(6);
+  cout << std::fixed;
+
+  for (const Instance& instance : getInstances()) {
+    runInstance(resultFileStream, instance);
+  }
+  cout << "c results written to " << resultFilePath << "\n";
+}
@@ -2611,6 +2611,18 @@ ADD::ExistAbstract(
 } // ADD::ExistAbstract
 
 
+ADD
+ADD::LogExistAbstract(
+  const ADD& cube) const
+{
+    DdManager *mgr = checkSameManager(cube);
+    DdNode *result = Cudd_addLogExistAbstract(mgr, node, cube.node);
+    checkReturnValue(result);
+    return ADD(p, result);
+
+} // ADD::LogExistAbstract
+
+
 ADD
 ADD::UnivAbstract(
   const ADD& cube) const
@@ -2695,6 +2707,18 @@ ADD::LogThreshold(
 } // ADD::LogThreshold
 
 
+ADD
+ADD::LogRoundOff(
+  const ADD& g) const
+{
+    DdManager *mgr = checkSameManager(g);
+    DdNode *result = Cudd_addApply(mgr, Cudd_addLogRoundOff, node, g.node);
+    checkReturnValue(result);
+    return ADD(p, result);
+
+} // ADD::LogRoundOff
+
+
 ADD
 ADD::SetNZ(
   const ADD& g) const
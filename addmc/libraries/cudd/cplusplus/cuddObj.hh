@@ -316,6 +316,7 @@ public:
     ADD operator|=(const ADD& other);
     bool IsZero() const;
     ADD ExistAbstract(const ADD& cube) const;
+    ADD LogExistAbstract(const ADD& cube) const;
     ADD UnivAbstract(const ADD& cube) const;
     ADD OrAbstract(const ADD& cube) const;
     ADD Plus(const ADD& g) const;
@@ -323,6 +324,7 @@ public:
     ADD Times(const ADD& g) const;
     ADD Threshold(const ADD& g) const;
     ADD LogThreshold(const ADD& g) const;
+    ADD LogRoundOff(const ADD& g) const;
     ADD SetNZ(const ADD& g) const;
     ADD Divide(const ADD& g) const;
     ADD Minus(const ADD& g) const;
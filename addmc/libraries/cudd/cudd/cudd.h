@@ -665,6 +665,7 @@ extern int Cudd_bddBindVar(DdManager *dd, int index);
 extern int Cudd_bddUnbindVar(DdManager *dd, int index);
 extern int Cudd_bddVarIsBound(DdManager *dd, int index);
 extern DdNode * Cudd_addExistAbstract(DdManager *manager, DdNode *f, DdNode *cube);
+extern DdNode * Cudd_addLogExistAbstract(DdManager *manager, DdNode *f, DdNode *cube);
 extern DdNode * Cudd_addUnivAbstract(DdManager *manager, DdNode *f, DdNode *cube);
 extern DdNode * Cudd_addOrAbstract(DdManager *manager, DdNode *f, DdNode *cube);
 extern DdNode * Cudd_addApply(DdManager *dd, DD_AOP op, DdNode *f, DdNode *g);
@@ -673,6 +674,7 @@ extern DdNode * Cudd_addLogSumExp(DdManager *dd, DdNode **f, DdNode **g);
 extern DdNode * Cudd_addTimes(DdManager *dd, DdNode **f, DdNode **g);
 extern DdNode * Cudd_addThreshold(DdManager *dd, DdNode **f, DdNode **g);
 extern DdNode * Cudd_addLogThreshold(DdManager *dd, DdNode **f, DdNode **g);
+extern DdNode * Cudd_addLogRoundOff(DdManager *dd, DdNode **f, DdNode **g);
 extern DdNode * Cudd_addSetNZ(DdManager *dd, DdNode **f, DdNode **g);
 extern DdNode * Cudd_addDivide(DdManager *dd, DdNode **f, DdNode **g);
 extern DdNode * Cudd_addMinus(DdManager *dd, DdNode **f, DdNode **g);
@@ -46,10 +46,25 @@
 #include "util.h"
 #include "cuddInt.h"
 
+#ifndef CUDD_EXACT_LOGSUMEXP
+#include <pthread.h>
+#endif
+
 /*---------------------------------------------------------------------------*/
 /* Constant declarations                                                     */
 /*---------------------------------------------------------------------------*/
 
+#ifndef CUDD_EXACT_LOGSUMEXP
+/* Table of log10(1 + 10^-d) for 0 <= d <= DD_LSE_TABLE_RANGE. */
+#define DD_LSE_TABLE_RANGE 8
+#define DD_LSE_TABLE_STEPS 512 /* per unit of d */
+#define DD_LSE_TABLE_SIZE (DD_LSE_TABLE_RANGE * DD_LSE_TABLE_STEPS + 1)
+
+#define DD_LN10 2.30258509299404568402
+#define DD_LOG10E 0.43429448190325182765
+#define DD_LOG2_10 3.32192809488736234787
+#endif
+
 
 /*---------------------------------------------------------------------------*/
 /* Stucture declarations                                                     */
@@ -65,6 +80,12 @@
 /* Variable declarations                                                     */
 /*---------------------------------------------------------------------------*/
 
+#ifndef CUDD_EXACT_LOGSUMEXP
+static double lseTable[DD_LSE_TABLE_SIZE]; /* log10(1 + 10^-d) */
+static double lseSlopeTable[DD_LSE_TABLE_SIZE]; /* derivative -10^-d / (1 + 10^-d) */
+static pthread_once_t lseTableOnce = PTHREAD_ONCE_INIT;
+#endif
+
 
 /*---------------------------------------------------------------------------*/
 /* Macro declarations                                                        */
@@ -76,6 +97,11 @@
 /* Static function prototypes                                                */
 /*---------------------------------------------------------------------------*/
 
+#ifndef CUDD_EXACT_LOGSUMEXP
+static void ddLogSumExpTableFill(void);
+static double ddLog10OnePlusExp10(double d);
+#endif
+
 /** \endcond */
 
 
@@ -160,6 +186,10 @@ Cudd_addPlus(
 
   @return NULL if not a terminal case; log10(10^f + 10^g) otherwise.
 
+  @details Unless CUDD_EXACT_LOGSUMEXP is defined at compile time,
+  log10(1 + 10^-|f-g|) is interpolated from a table (absolute error
+  below 1e-10) instead of calling exp10 and log10.
+
   @sideeffect None
 
   @see Cudd_addApply
@@ -183,7 +213,11 @@ Cudd_addLogSumExp(
         f = cuddV(F);
         g = cuddV(G);
         m = fmax(f, g);
+#ifdef CUDD_EXACT_LOGSUMEXP
         value = log10(exp10(f - m) + exp10(g - m)) + m;
+#else
+        value = m + ddLog10OnePlusExp10(m - fmin(f, g));
+#endif
         res = cuddUniqueConst(dd,value);
         return res;
     }
@@ -307,6 +341,40 @@ Cudd_addLogThreshold(
 } /* end of Cudd_addLogThreshold */
 
 
+/**
+  @brief f rounded to nearest multiple of g; minusinfinity stays.
+
+  @details Log-round-off operator for Apply. In the log domain, terminals
+  within a factor of 10^g of each other are merged, which changes each
+  value by at most g/2.
+
+  @return NULL if not a terminal case; f op g otherwise.
+
+  @sideeffect None
+
+  @see Cudd_addApply Cudd_addRoundOff
+
+*/
+DdNode *
+Cudd_addLogRoundOff(
+  DdManager * dd,
+  DdNode ** f,
+  DdNode ** g)
+{
+    DdNode *F, *G;
+    CUDD_VALUE_TYPE value;
+
+    F = *f; G = *g;
+    if (F == DD_MINUS_INFINITY(dd) || F == DD_PLUS_INFINITY(dd)) return(F);
+    if (cuddIsConstant(F) && cuddIsConstant(G)) {
+        value = cuddV(G) * round(cuddV(F) / cuddV(G));
+        return(cuddUniqueConst(dd,value));
+    }
+    return(NULL);
+
+} /* end of Cudd_addLogRoundOff */
+
+
 /**
   @brief This operator sets f to the value of g wherever g != 0.
 
@@ -993,6 +1061,75 @@ cuddAddMonadicApplyRecur(
 } /* end of cuddAddMonadicApplyRecur */
 
 
+/**
+  @brief Fills the table used by Cudd_addLogSumExp.
+
+  @details Called by Cudd_Init; the table is shared by all managers.
+
+  @sideeffect None
+
+*/
+void
+cuddLogSumExpInit(void)
+{
+#ifndef CUDD_EXACT_LOGSUMEXP
+    pthread_once(&lseTableOnce, ddLogSumExpTableFill);
+#endif
+
+} /* end of cuddLogSumExpInit */
+
+
 /*---------------------------------------------------------------------------*/
 /* Definition of static functions                                            */
 /*---------------------------------------------------------------------------*/
+
+#ifndef CUDD_EXACT_LOGSUMEXP
+/**
+  @brief Fills lseTable and lseSlopeTable.
+
+  @sideeffect None
+
+*/
+static void
+ddLogSumExpTableFill(void)
+{
+    int i;
+    double x;
+
+    for (i = 0; i < DD_LSE_TABLE_SIZE; i++) {
+        x = exp10(-(double) i / DD_LSE_TABLE_STEPS);
+        lseTable[i] = log10(1 + x);
+        lseSlopeTable[i] = -x / (1 + x);
+    }
+
+} /* end of ddLogSumExpTableFill */
+
+
+/**
+  @brief Computes log10(1 + 10^-d) for d &ge; 0.
+
+  @details Uses a second-order Taylor step from the nearest table entry,
+  with the second derivative ln(10) * s * (1 + s) recovered from the slope
+  s. The step is at most half a table interval, so the absolute error is
+  below 1e-10. Beyond the table, log1p and exp2 are used.
+
+  @sideeffect None
+
+*/
+static double
+ddLog10OnePlusExp10(
+  double d)
+{
+    int i;
+    double r, s;
+
+    if (d >= DD_LSE_TABLE_RANGE) {
+        return log1p(exp2(-d * DD_LOG2_10)) * DD_LOG10E;
+    }
+    i = (int) (d * DD_LSE_TABLE_STEPS + 0.5);
+    r = d - (double) i / DD_LSE_TABLE_STEPS;
+    s = lseSlopeTable[i];
+    return lseTable[i] + r * (s - 0.5 * r * DD_LN10 * s * (1 + s));
+
+} /* end of ddLog10OnePlusExp10 */
+#endif
@@ -117,6 +117,7 @@ Cudd_Init(
     if (maxMemory == 0) {
         maxMemory = getSoftDataLimit();
     }
+    cuddLogSumExpInit();
     looseUpTo = (unsigned int) ((maxMemory / sizeof(DdNode)) / DD_MAX_LOOSE_FRACTION);
     unique = cuddInitTable(numVars,numVarsZ,numSlots,looseUpTo);
     if (unique == NULL) return(NULL);
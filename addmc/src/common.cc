@@ -4,10 +4,15 @@
 
 bool weightedCounting;
 bool projectedCounting;
+bool logCounting;
 Int randomSeed;
 bool multiplePrecision;
 Int verboseCnf;
 Int verboseSolving;
+string joinTreeCacheDir;
+bool xorElimination;
+bool preprocessing;
+bool componentDecomposition;
 
 TimePoint toolStartPoint;
 
@@ -70,6 +75,42 @@ Float util::getDuration(TimePoint start) {
   return std::chrono::duration_cast<std::chrono::milliseconds>(getTimePoint() - start).count() / 1e3l;
 }
 
+void util::appendVarint(string& bytes, Int num) {
+  assert(num >= 0);
+  while (num >= 0x80) {
+    bytes.push_back(static_cast<char>((num & 0x7f) | 0x80));
+    num >>= 7;
+  }
+  bytes.push_back(static_cast<char>(num));
+}
+
+Int util::readVarint(const string& bytes, size_t& pos) {
+  Int num = 0;
+  for (Int shift = 0; shift < 63; shift += 7) {
+    if (pos >= bytes.size()) {
+      throw MyError("truncated varint at byte ", pos, " of binary join tree");
+    }
+    unsigned char byte = bytes.at(pos++);
+    num |= static_cast<Int>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return num;
+    }
+  }
+  throw MyError("overlong varint before byte ", pos, " of binary join tree");
+}
+
+string util::getHashKey(const string& text) {
+  uint64_t hash = 14695981039346656037ull; // FNV-1a offset basis
+  for (unsigned char byte : text) {
+    hash ^= byte;
+    hash *= 1099511628211ull; // FNV prime
+  }
+
+  std::ostringstream outStringStream;
+  outStringStream << std::hex << setw(16) << std::setfill('0') << hash;
+  return outStringStream.str();
+}
+
 vector<string> util::splitInputLine(string line) {
   std::istringstream inStringStream(line);
   vector<string> words;
@@ -105,6 +146,18 @@ UnsatSolverException::UnsatSolverException() {
   cout << WARNING << "unsatisfiable CNF, according to SAT solver\n";
 }
 
+/* class InconsistentXorException =========================================== */
+
+InconsistentXorException::InconsistentXorException() {
+  cout << WARNING << "unsatisfiable CNF, according to Gaussian elimination over XOR clauses\n";
+}
+
+/* class UnsatPreprocessorException ========================================= */
+
+UnsatPreprocessorException::UnsatPreprocessorException() {
+  cout << WARNING << "unsatisfiable CNF, according to preprocessor\n";
+}
+
 /* classes for CNF formulas ================================================= */
 
 /* class Number ============================================================= */
@@ -380,6 +433,411 @@ Set<Int> Clause::getClauseVars() const {
   return vars;
 }
 
+/* class XorSystem ========================================================== */
+
+bool XorSystem::hasBit(const vector<uint64_t>& row, Int var) {
+  return (row.at(var / 64) >> (var % 64)) & 1;
+}
+
+void XorSystem::flipBit(vector<uint64_t>& row, Int var) {
+  row.at(var / 64) ^= uint64_t(1) << (var % 64);
+}
+
+void XorSystem::addRow(vector<uint64_t>& row, const vector<uint64_t>& otherRow) {
+  uint64_t* words = row.data();
+  const uint64_t* otherWords = otherRow.data();
+  for (size_t i = 0; i < row.size(); i++) {
+    words[i] ^= otherWords[i];
+  }
+}
+
+Int XorSystem::getRowVarCount(const vector<uint64_t>& row) {
+  Int count = -static_cast<Int>(row.front() & 1); // parity bit
+  for (uint64_t word : row) {
+    count += __builtin_popcountll(word);
+  }
+  return count;
+}
+
+Int XorSystem::getRowSpan(const vector<uint64_t>& row) {
+  Int minVar = MAX_INT;
+  Int maxVar = MIN_INT;
+  for (Int wordIndex = 0; wordIndex < row.size(); wordIndex++) {
+    uint64_t word = row.at(wordIndex) & (wordIndex == 0 ? ~uint64_t(1) : ~uint64_t(0)); // skips parity bit
+    if (word != 0) {
+      minVar = min(minVar, wordIndex * 64 + __builtin_ctzll(word));
+      maxVar = max(maxVar, wordIndex * 64 + 63 - __builtin_clzll(word));
+    }
+  }
+  return minVar == MAX_INT ? 0 : maxVar - minVar;
+}
+
+Int XorSystem::getLiteralCount() const {
+  Int count = 0;
+  for (const vector<uint64_t>& row : rows) {
+    count += getRowVarCount(row);
+  }
+  return count;
+}
+
+Int XorSystem::getSpanSum() const {
+  Int spanSum = 0;
+  for (const vector<uint64_t>& row : rows) {
+    spanSum += getRowSpan(row);
+  }
+  return spanSum;
+}
+
+Clause XorSystem::getClause(const vector<uint64_t>& row) const {
+  Clause clause(true);
+  bool negatingFlag = !hasBit(row, 0);
+  for (Int var = 1; var < wordCount * 64; var++) {
+    if (hasBit(row, var)) {
+      clause.insertLiteral(negatingFlag ? -var : var);
+      negatingFlag = false;
+    }
+  }
+  return clause;
+}
+
+vector<Int> XorSystem::reduce() {
+  Map<Int, Int> varCounts; // pivots are picked among rarest vars to limit fill-in
+  for (const vector<uint64_t>& row : rows) {
+    for (Int var = 1; var < wordCount * 64; var++) {
+      if (hasBit(row, var)) {
+        varCounts[var]++;
+      }
+    }
+  }
+
+  vector<vector<uint64_t>> basisRows;
+  vector<Int> pivotVars;
+  vector<Int> keptRowIndices;
+  for (Int rowIndex = 0; rowIndex < rows.size(); rowIndex++) {
+    vector<uint64_t> row = rows.at(rowIndex);
+    for (Int i = 0; i < basisRows.size(); i++) {
+      if (hasBit(row, pivotVars.at(i))) {
+        addRow(row, basisRows.at(i));
+      }
+    }
+
+    Int pivotVar = MIN_INT;
+    for (Int var = 1; var < wordCount * 64; var++) {
+      if (hasBit(row, var) && (pivotVar == MIN_INT || varCounts.at(var) < varCounts.at(pivotVar))) {
+        pivotVar = var;
+      }
+    }
+    if (pivotVar == MIN_INT) { // 0 = parity
+      if (hasBit(row, 0)) {
+        throw InconsistentXorException();
+      }
+      continue;
+    }
+
+    for (vector<uint64_t>& basisRow : basisRows) { // back substitution
+      if (hasBit(basisRow, pivotVar)) {
+        addRow(basisRow, row);
+      }
+    }
+    basisRows.push_back(row);
+    pivotVars.push_back(pivotVar);
+    keptRowIndices.push_back(rowIndex);
+  }
+
+  rows = basisRows;
+  return keptRowIndices;
+}
+
+void XorSystem::sparsify() {
+  for (Int pass = 0; pass < MAX_SPARSIFYING_PASSES; pass++) {
+    bool changedFlag = false;
+    for (Int i = 0; i < rows.size(); i++) {
+      for (Int j = 0; j < rows.size(); j++) {
+        if (i == j) {
+          continue;
+        }
+        vector<uint64_t> row = rows.at(i);
+        addRow(row, rows.at(j));
+        if (getRowVarCount(row) < getRowVarCount(rows.at(i)) && getRowSpan(row) <= getRowSpan(rows.at(i))) {
+          rows.at(i) = row;
+          changedFlag = true;
+        }
+      }
+    }
+    if (!changedFlag) {
+      return;
+    }
+  }
+}
+
+XorSystem::XorSystem(const vector<Clause>& xorClauses, Int declaredVarCount) {
+  wordCount = declaredVarCount / 64 + 1;
+  for (const Clause& clause : xorClauses) {
+    vector<uint64_t> row(wordCount, 0);
+    flipBit(row, 0); // odd number of true literals
+    for (Int literal : clause) {
+      flipBit(row, abs(literal));
+      if (literal < 0) {
+        flipBit(row, 0);
+      }
+    }
+    rows.push_back(row);
+  }
+}
+
+/* class CnfPreprocessor ==================================================== */
+
+Int CnfPreprocessor::getRepresentative(Int literal) const {
+  auto it = replacedVars.find(abs(literal));
+  while (it != replacedVars.end()) {
+    literal = literal > 0 ? it->second : -it->second;
+    it = replacedVars.find(abs(literal));
+  }
+  return literal;
+}
+
+void CnfPreprocessor::removeClause(Int clauseIndex) {
+  removedFlags.at(clauseIndex) = true;
+  for (Int literal : cnf.clauses.at(clauseIndex)) {
+    varToClauseIndices.at(abs(literal)).erase(clauseIndex);
+  }
+}
+
+void CnfPreprocessor::finishClause(Int clauseIndex, bool parityFlip) {
+  Clause& clause = cnf.clauses.at(clauseIndex);
+
+  vector<Int> complementedVars;
+  for (Int literal : clause) {
+    if (literal > 0 && clause.contains(-literal)) {
+      complementedVars.push_back(literal);
+    }
+  }
+  if (!complementedVars.empty()) {
+    if (!clause.xorFlag) { // tautology
+      removeClause(clauseIndex);
+      return;
+    }
+    for (Int var : complementedVars) { // var XOR -var is true
+      clause.erase(var);
+      clause.erase(-var);
+      varToClauseIndices.at(var).erase(clauseIndex);
+      parityFlip = !parityFlip;
+    }
+  }
+
+  if (clause.xorFlag && parityFlip) { // remaining literals must have even parity
+    if (clause.empty()) {
+      removedFlags.at(clauseIndex) = true;
+      return;
+    }
+    Int literal = *std::min_element(clause.begin(), clause.end());
+    clause.erase(literal);
+    clause.insert(-literal);
+  }
+
+  if (clause.empty()) {
+    throw UnsatPreprocessorException();
+  }
+  if (clause.size() == 1) {
+    unitLiterals.push(*clause.begin());
+  }
+}
+
+void CnfPreprocessor::propagateUnits() {
+  while (!unitLiterals.empty()) {
+    Int literal = unitLiterals.front();
+    unitLiterals.pop();
+    if (fixedLiterals.contains(literal)) {
+      continue;
+    }
+    if (fixedLiterals.contains(-literal)) {
+      throw UnsatPreprocessorException();
+    }
+    fixLiteral(literal);
+  }
+}
+
+void CnfPreprocessor::fixLiteral(Int literal) {
+  fixedLiterals.insert(literal);
+  propagatedUnitCount++;
+  cnf.substitutions.push_back({literal, 0});
+  Cnf::foldSubstitution(cnf.literalWeights, cnf.substitutions.back());
+
+  Int var = abs(literal);
+  Set<Int> clauseIndices = varToClauseIndices.at(var);
+  for (Int clauseIndex : clauseIndices) {
+    Clause& clause = cnf.clauses.at(clauseIndex);
+    if (!clause.xorFlag && clause.contains(literal)) {
+      removeClause(clauseIndex);
+      continue;
+    }
+    bool parityFlip = clause.contains(literal);
+    clause.erase(literal);
+    clause.erase(-literal);
+    varToClauseIndices.at(var).erase(clauseIndex);
+    finishClause(clauseIndex, parityFlip);
+  }
+}
+
+void CnfPreprocessor::replaceVar(Int var, Int literal) {
+  replacedVars[var] = literal;
+  substitutedVarCount++;
+  cnf.substitutions.push_back({var, literal});
+  Cnf::foldSubstitution(cnf.literalWeights, cnf.substitutions.back());
+
+  Set<Int> clauseIndices = varToClauseIndices.at(var);
+  for (Int clauseIndex : clauseIndices) {
+    Clause& clause = cnf.clauses.at(clauseIndex);
+    for (Int sign : {1, -1}) {
+      if (clause.contains(sign * var)) {
+        clause.erase(sign * var);
+        clause.insertLiteral(sign * literal); // XOR cancels duplicate literal
+      }
+    }
+    varToClauseIndices.at(var).erase(clauseIndex);
+    if (clause.contains(literal) || clause.contains(-literal)) {
+      varToClauseIndices.at(abs(literal)).insert(clauseIndex);
+    }
+    else { // XOR cancelled both occurrences
+      varToClauseIndices.at(abs(literal)).erase(clauseIndex);
+    }
+    finishClause(clauseIndex, false);
+  }
+}
+
+bool CnfPreprocessor::substituteEquivalences() {
+  std::set<pair<Int, Int>> binaryClauses; // sorted literals
+  vector<pair<Int, Int>> equivalences; // (literal, literal) pairs of equivalent literals
+  for (Int clauseIndex = 0; clauseIndex < cnf.clauses.size(); clauseIndex++) {
+    const Clause& clause = cnf.clauses.at(clauseIndex);
+    if (removedFlags.at(clauseIndex) || clause.size() != 2) {
+      continue;
+    }
+    vector<Int> literals = util::getSortedNums(clause);
+    if (clause.xorFlag) {
+      equivalences.push_back({literals.front(), -literals.back()});
+    }
+    else {
+      binaryClauses.insert({literals.front(), literals.back()});
+      if (binaryClauses.contains({min(-literals.front(), -literals.back()), max(-literals.front(), -literals.back())})) {
+        equivalences.push_back({literals.front(), -literals.back()});
+      }
+    }
+  }
+
+  bool substitutedFlag = false;
+  for (auto [literal1, literal2] : equivalences) {
+    literal1 = getRepresentative(literal1);
+    literal2 = getRepresentative(literal2);
+    if (literal1 == literal2 || fixedLiterals.contains(literal1) || fixedLiterals.contains(-literal1) || fixedLiterals.contains(literal2) || fixedLiterals.contains(-literal2)) {
+      continue;
+    }
+    if (literal1 == -literal2) {
+      throw UnsatPreprocessorException();
+    }
+
+    Int var1 = abs(literal1);
+    Int var2 = abs(literal2);
+    bool removingVar1 = cnf.outerVars.contains(var1) == cnf.outerVars.contains(var2) ? var1 > var2 : cnf.outerVars.contains(var2); // outer vars must stay
+    if (removingVar1) {
+      replaceVar(var1, literal1 > 0 ? literal2 : -literal2);
+    }
+    else {
+      replaceVar(var2, literal2 > 0 ? literal1 : -literal1);
+    }
+    propagateUnits();
+    substitutedFlag = true;
+  }
+  return substitutedFlag;
+}
+
+void CnfPreprocessor::removeSubsumedClauses() {
+  vector<Int> clauseIndices;
+  Map<Int, vector<Int>> literalToClauseIndices;
+  for (Int clauseIndex = 0; clauseIndex < cnf.clauses.size(); clauseIndex++) {
+    if (!removedFlags.at(clauseIndex)) {
+      clauseIndices.push_back(clauseIndex);
+      for (Int literal : cnf.clauses.at(clauseIndex)) {
+        literalToClauseIndices[literal].push_back(clauseIndex);
+      }
+    }
+  }
+  std::stable_sort(clauseIndices.begin(), clauseIndices.end(), [this](Int i, Int j) {
+    return cnf.clauses.at(i).size() < cnf.clauses.at(j).size();
+  });
+
+  for (Int clauseIndex : clauseIndices) {
+    if (removedFlags.at(clauseIndex)) {
+      continue;
+    }
+    const Clause& clause = cnf.clauses.at(clauseIndex);
+    Int rarestLiteral = *std::min_element(clause.begin(), clause.end(), [&literalToClauseIndices](Int a, Int b) {
+      return literalToClauseIndices.at(a).size() < literalToClauseIndices.at(b).size();
+    });
+    for (Int otherIndex : literalToClauseIndices.at(rarestLiteral)) {
+      const Clause& otherClause = cnf.clauses.at(otherIndex);
+      if (otherIndex == clauseIndex || removedFlags.at(otherIndex) || otherClause.size() < clause.size()) {
+        continue;
+      }
+      if (clause.xorFlag || otherClause.xorFlag) { // XOR clauses are only removed if duplicate
+        if (clause.xorFlag != otherClause.xorFlag || otherClause.size() != clause.size()) {
+          continue;
+        }
+      }
+      bool subsumingFlag = true;
+      for (Int literal : clause) {
+        if (!otherClause.contains(literal)) {
+          subsumingFlag = false;
+          break;
+        }
+      }
+      if (subsumingFlag) {
+        removeClause(otherIndex);
+        subsumedClauseCount++;
+      }
+    }
+  }
+}
+
+CnfPreprocessor::CnfPreprocessor(Cnf& cnf) : cnf(cnf) {
+  TimePoint preprocessingStartPoint = util::getTimePoint();
+  Int originalClauseCount = cnf.clauses.size();
+  cnf.originalLiteralWeights = cnf.literalWeights;
+
+  removedFlags.resize(cnf.clauses.size(), false);
+  for (Int var = 1; var <= cnf.declaredVarCount; var++) {
+    varToClauseIndices[var] = Set<Int>();
+  }
+  for (Int clauseIndex = 0; clauseIndex < cnf.clauses.size(); clauseIndex++) {
+    for (Int literal : cnf.clauses.at(clauseIndex)) {
+      varToClauseIndices.at(abs(literal)).insert(clauseIndex);
+    }
+  }
+  for (Int clauseIndex = 0; clauseIndex < cnf.clauses.size(); clauseIndex++) {
+    finishClause(clauseIndex, false); // finds units and XOR tautologies
+  }
+
+  do {
+    propagateUnits();
+  } while (substituteEquivalences());
+  removeSubsumedClauses();
+
+  vector<Clause> clauses = cnf.clauses;
+  cnf.clauses.clear();
+  cnf.varToClauses.clear();
+  for (Int clauseIndex = 0; clauseIndex < clauses.size(); clauseIndex++) {
+    if (!removedFlags.at(clauseIndex)) {
+      cnf.addClause(clauses.at(clauseIndex));
+    }
+  }
+
+  util::printRow("propagatedUnitCount", propagatedUnitCount);
+  util::printRow("substitutedVarCount", substitutedVarCount);
+  util::printRow("subsumedClauseCount", subsumedClauseCount);
+  util::printRow("removedClauseCount", originalClauseCount - static_cast<Int>(cnf.clauses.size()));
+  util::printRow("preprocessingSeconds", util::getDuration(preprocessingStartPoint));
+}
+
 /* class Cnf ================================================================ */
 
 void Cnf::printClauses() const {
@@ -443,6 +901,40 @@ Graph Cnf::getPrimalGraph() const {
   return graph;
 }
 
+vector<Int> Cnf::getVarComponents() const {
+  vector<Int> parents(declaredVarCount + 1); // union-find forest over vars
+  for (Int var = 0; var <= declaredVarCount; var++) {
+    parents.at(var) = var;
+  }
+  auto findRoot = [&parents](Int var) {
+    while (parents.at(var) != var) {
+      parents.at(var) = parents.at(parents.at(var)); // path halving
+      var = parents.at(var);
+    }
+    return var;
+  };
+
+  for (const Clause& clause : clauses) {
+    if (clause.empty()) {
+      continue;
+    }
+    Int root = findRoot(abs(*clause.begin()));
+    for (Int literal : clause) {
+      Int otherRoot = findRoot(abs(literal));
+      if (otherRoot != root) {
+        parents.at(max(root, otherRoot)) = min(root, otherRoot); // smallest var represents component
+        root = min(root, otherRoot);
+      }
+    }
+  }
+
+  vector<Int> components(declaredVarCount + 1, 0);
+  for (Int var : apparentVars) {
+    components.at(var) = findRoot(var);
+  }
+  return components;
+}
+
 vector<Int> Cnf::getRandomVarOrder() const {
   vector<Int> varOrder(apparentVars.begin(), apparentVars.end());
   std::mt19937 generator;
@@ -660,6 +1152,158 @@ void Cnf::completeLiteralWeights() {
   }
 }
 
+void Cnf::foldSubstitution(Map<Int, Number>& weights, pair<Int, Int> substitution) {
+  auto [var, literal] = substitution;
+  if (literal == 0) { // var is propagated literal
+    weights[-var] = Number("0"); // hidden var is adjusted by weight of literal
+    return;
+  }
+  Number& literalWeight = weights.at(literal);
+  literalWeight = literalWeight * weights.at(var);
+  Number& complementWeight = weights.at(-literal);
+  complementWeight = complementWeight * weights.at(-var);
+  weights[var] = Number("1");
+  weights[-var] = Number("0");
+}
+
+Map<Int, Number> Cnf::getWeightUpdates(const vector<string>& words, Int lineIndex) const {
+  if (words.size() % 2 == 0 || words.back() != "0") {
+    throw MyError("weight vector should be pairs of literal and weight ending with '0' | line ", lineIndex);
+  }
+  Map<Int, Number> weightUpdates;
+  for (Int i = 0; i + 1 < words.size(); i += 2) {
+    Int literal = stoll(words.at(i));
+    if (literal == 0 || abs(literal) > declaredVarCount) {
+      throw MyError("literal '", literal, "' inconsistent with declared var count '", declaredVarCount, "' | line ", lineIndex);
+    }
+    Number weight(words.at(i + 1));
+    if (weight <= Number()) {
+      throw MyError("weight must be positive | line ", lineIndex);
+    }
+    weightUpdates[literal] = weight;
+  }
+  return weightUpdates;
+}
+
+Map<Int, Number> Cnf::getFoldedLiteralWeights(const Map<Int, Number>& weightUpdates) const {
+  Map<Int, Number> weights = originalLiteralWeights.empty() ? literalWeights : originalLiteralWeights;
+  for (auto [literal, weight] : weightUpdates) {
+    weights[literal] = weight;
+    if (!weightUpdates.contains(-literal)) { // like completeLiteralWeights
+      if (weight >= Number("1")) {
+        throw MyError("weight of literal '", literal, "' must be below 1 without weight of literal '", -literal, "'");
+      }
+      weights[-literal] = Number("1") - weight;
+    }
+  }
+  for (const pair<Int, Int>& substitution : substitutions) {
+    foldSubstitution(weights, substitution);
+  }
+  return weights;
+}
+
+void Cnf::eliminateXors() {
+  TimePoint xorEliminationStartPoint = util::getTimePoint();
+
+  vector<Clause> xorClauses;
+  vector<Clause> orClauses;
+  for (const Clause& clause : clauses) {
+    (clause.xorFlag ? xorClauses : orClauses).push_back(clause);
+  }
+
+  XorSystem originalSystem(xorClauses, declaredVarCount);
+  XorSystem reducedSystem = originalSystem;
+  vector<Int> keptRowIndices = reducedSystem.reduce(); // may throw
+  reducedSystem.sparsify();
+
+  XorSystem independentSystem = originalSystem; // original rows without dependent ones
+  independentSystem.rows.clear();
+  for (Int rowIndex : keptRowIndices) {
+    independentSystem.rows.push_back(originalSystem.rows.at(rowIndex));
+  }
+  independentSystem.sparsify();
+
+  const XorSystem& system = pair(independentSystem.getSpanSum(), independentSystem.getLiteralCount()) <= pair(reducedSystem.getSpanSum(), reducedSystem.getLiteralCount()) ? independentSystem : reducedSystem; // substitution may help planning less than locality does
+
+  clauses.clear();
+  varToClauses.clear();
+  for (const Clause& clause : orClauses) {
+    addClause(clause);
+  }
+  for (const vector<uint64_t>& row : system.rows) {
+    addClause(system.getClause(row));
+  }
+
+  util::printRow("xorClauseCount", xorClauses.size());
+  util::printRow("eliminatedXorClauseCount", xorClauses.size() - system.rows.size());
+  util::printRow("xorLiteralCount", originalSystem.getLiteralCount());
+  util::printRow("eliminatedXorLiteralCount", originalSystem.getLiteralCount() - system.getLiteralCount());
+  util::printRow("xorEliminationSeconds", util::getDuration(xorEliminationStartPoint));
+}
+
+void Cnf::extendAssignment(Assignment& assignment) const {
+  for (Int var = 1; var <= declaredVarCount; var++) {
+    if (!apparentVars.contains(var) && !assignment.contains(var)) { // maximizes weight of hidden var
+      assignment[var] = literalWeights.at(var) >= literalWeights.at(-var);
+    }
+  }
+
+  for (auto it = substitutions.rbegin(); it != substitutions.rend(); it++) { // replacing literals may be replaced later
+    auto [literal, equivalentLiteral] = *it;
+    if (equivalentLiteral == 0) {
+      assignment[abs(literal)] = literal > 0;
+    }
+    else {
+      assignment[literal] = assignment.getValue(abs(equivalentLiteral)) == (equivalentLiteral > 0);
+    }
+  }
+}
+
+void Cnf::writeFile(string filePath) const {
+  std::ofstream outputFileStream(filePath);
+  if (!outputFileStream.is_open()) {
+    throw MyError("unable to open file '", filePath, "'");
+  }
+
+  outputFileStream << "p cnf " << declaredVarCount << " " << clauses.size() + substitutions.size() << "\n";
+
+  if (weightedCounting) {
+    const Map<Int, Number>& weights = substitutions.empty() ? literalWeights : originalLiteralWeights; // removed vars are restored by clauses below
+    outputFileStream << std::setprecision(std::numeric_limits<Float>::max_digits10);
+    for (Int var = 1; var <= declaredVarCount; var++) {
+      if (weights.at(var) != Number("1") || weights.at(-var) != Number("1")) {
+        outputFileStream << "c p weight " << var << " " << weights.at(var) << " 0\n";
+        outputFileStream << "c p weight " << -var << " " << weights.at(-var) << " 0\n";
+      }
+    }
+  }
+
+  if (projectedCounting) {
+    outputFileStream << "c p show";
+    for (Int var : util::getSortedNums(outerVars)) {
+      outputFileStream << " " << var;
+    }
+    outputFileStream << " 0\n";
+  }
+
+  for (const Clause& clause : clauses) {
+    outputFileStream << (clause.xorFlag ? "x " : "");
+    for (Int literal : util::getSortedNums(clause)) {
+      outputFileStream << literal << " ";
+    }
+    outputFileStream << "0\n";
+  }
+
+  for (auto [literal, equivalentLiteral] : substitutions) {
+    if (equivalentLiteral == 0) {
+      outputFileStream << literal << " 0\n";
+    }
+    else { // literal XOR -equivalentLiteral
+      outputFileStream << "x " << literal << " " << -equivalentLiteral << " 0\n";
+    }
+  }
+}
+
 Cnf::Cnf() {}
 
 Cnf::Cnf(string filePath) {
@@ -721,7 +1365,7 @@ Cnf::Cnf(string filePath) {
         }
         literalWeights[literal] = weight;
       }
-      else if (projectedCounting && (frontWord == "vp" || isMc21ShowLine(words))) { // show line optionally ends with 0
+      else if (frontWord == "vp" || isMc21ShowLine(words)) { // show line optionally ends with 0; read even without projected counting for join tree cache keys
         if (problemLineIndex == MIN_INT) {
           throw MyError("no problem line before projected var | line ", lineIndex, ": ", line);
         }
@@ -737,7 +1381,7 @@ Cnf::Cnf(string filePath) {
             throw MyError("var '", num, "' inconsistent with declared var count '", declaredVarCount, "' | line ", lineIndex);
           }
           else {
-            outerVars.insert(num);
+            shownVars.insert(num);
           }
         }
       }
@@ -794,9 +1438,10 @@ Cnf::Cnf(string filePath) {
     throw MyError("no problem line before CNF file ends on line ", lineIndex);
   }
 
-  setApparentVars();
-
-  if (!projectedCounting) {
+  if (projectedCounting) {
+    outerVars = shownVars;
+  }
+  else {
     for (Int var = 1; var <= declaredVarCount; var++) {
       outerVars.insert(var);
     }
@@ -804,6 +1449,16 @@ Cnf::Cnf(string filePath) {
 
   completeLiteralWeights();
 
+  if (preprocessing) {
+    CnfPreprocessor preprocessor(*this);
+  }
+
+  if (xorElimination) {
+    eliminateXors();
+  }
+
+  setApparentVars();
+
   if (verboseCnf >= PARSED_INPUT) {
     util::printRow("declaredVarCount", declaredVarCount);
     util::printRow("apparentVarCount", apparentVars.size());
@@ -890,14 +1545,18 @@ Set<Int> JoinNode::backupNonterminalIndices;
 
 Cnf JoinNode::cnf;
 
+void JoinNode::clearStaticFields() {
+  nodeCount = 0;
+  terminalCount = 0;
+  nonterminalIndices.clear();
+}
+
 void JoinNode::resetStaticFields() {
   backupNodeCount = nodeCount;
   backupTerminalCount = terminalCount;
   backupNonterminalIndices = nonterminalIndices;
 
-  nodeCount = 0;
-  terminalCount = 0;
-  nonterminalIndices.clear();
+  clearStaticFields();
 }
 
 void JoinNode::restoreStaticFields() {
@@ -981,28 +1640,51 @@ JoinTerminal::JoinTerminal() {
 
 /* class JoinNonterminal ===================================================== */
 
-void JoinNonterminal::printNode(string startWord) const {
-  cout << startWord << nodeIndex + 1 << " ";
+void JoinNonterminal::printNode(string startWord, ostream& outputStream) const {
+  outputStream << startWord << nodeIndex + 1 << " ";
 
   for (const JoinNode* child : children) {
-    cout << child->nodeIndex + 1 << " ";
+    outputStream << child->nodeIndex + 1 << " ";
   }
 
-  cout << ELIM_VARS_WORD;
+  outputStream << ELIM_VARS_WORD;
   for (Int var : projectionVars) {
-    cout << " " << var;
+    outputStream << " " << var;
   }
 
-  cout << "\n";
+  outputStream << "\n";
+}
+
+void JoinNonterminal::printSubtree(string startWord, ostream& outputStream) const {
+  for (const JoinNode* child : children) {
+    if (!child->isTerminal()) {
+      static_cast<const JoinNonterminal*>(child)->printSubtree(startWord, outputStream);
+    }
+  }
+  printNode(startWord, outputStream);
+}
+
+void JoinNonterminal::appendNodeBytes(string& bytes) const {
+  util::appendVarint(bytes, nodeIndex + 1);
+
+  util::appendVarint(bytes, children.size());
+  for (const JoinNode* child : children) {
+    util::appendVarint(bytes, child->nodeIndex + 1);
+  }
+
+  util::appendVarint(bytes, projectionVars.size());
+  for (Int var : projectionVars) {
+    util::appendVarint(bytes, var);
+  }
 }
 
-void JoinNonterminal::printSubtree(string startWord) const {
+void JoinNonterminal::appendSubtreeBytes(string& bytes) const {
   for (const JoinNode* child : children) {
     if (!child->isTerminal()) {
-      static_cast<const JoinNonterminal*>(child)->printSubtree(startWord);
+      static_cast<const JoinNonterminal*>(child)->appendSubtreeBytes(bytes);
     }
   }
-  printNode(startWord);
+  appendNodeBytes(bytes);
 }
 
 Int JoinNonterminal::getWidth(const Assignment& assignment) const {
@@ -1166,6 +1848,340 @@ JoinNonterminal::JoinNonterminal(const vector<JoinNode*>& children, const Set<In
   }
 }
 
+/* class JoinTreeCache ===================================================== */
+
+string JoinTreeCache::getStructureKey(const Cnf& cnf) {
+  string text = to_string(cnf.declaredVarCount) + " " + to_string(cnf.clauses.size()) + "\n";
+  for (const Clause& clause : cnf.clauses) {
+    for (Int var : util::getSortedNums(clause.getClauseVars())) {
+      text += to_string(var) + " ";
+    }
+    text += "0\n";
+  }
+  for (Int var : util::getSortedNums(cnf.shownVars)) { // same with or without projected counting, like LG
+    text += to_string(var) + " ";
+  }
+  text += "0\n";
+
+  return util::getHashKey(text);
+}
+
+bool JoinTreeCache::hasJoinTree() const {
+  return cachedWidth != MAX_INT;
+}
+
+void JoinTreeCache::printJoinTree() const {
+  std::ifstream inputFileStream(filePath);
+  cout << inputFileStream.rdbuf();
+}
+
+bool JoinTreeCache::storeJoinTree(const JoinNonterminal* joinRoot, Int declaredVarCount, Int declaredClauseCount, Int declaredNodeCount, Int width, Float plannerDuration) {
+  if (filePath.empty() || width >= cachedWidth || !storingFlag) {
+    return false;
+  }
+
+  string tempFilePath = filePath + ".tmp" + to_string(getpid()); // renamed after writing so that readers never see partial files
+  std::ofstream outputFileStream(tempFilePath);
+  outputFileStream << "p " << JOIN_TREE_WORD << " " << declaredVarCount << " " << declaredClauseCount << " " << declaredNodeCount << "\n";
+  joinRoot->printSubtree("", outputFileStream);
+  outputFileStream.precision(std::numeric_limits<Float>::digits10);
+  outputFileStream << "c joinTreeWidth " << width << "\n";
+  outputFileStream << "c seconds " << plannerDuration << "\n";
+  outputFileStream.close();
+
+  if (!outputFileStream || std::rename(tempFilePath.c_str(), filePath.c_str()) != 0) {
+    cout << WARNING << "failed to write join tree cache file " << filePath << "\n";
+    std::remove(tempFilePath.c_str());
+    return false;
+  }
+
+  cachedWidth = width;
+  cout << "c stored join tree of width " << width << " in cache file " << filePath << "\n";
+  return true;
+}
+
+JoinTreeCache::JoinTreeCache(const Cnf& cnf) {
+  if (joinTreeCacheDir.empty()) {
+    return;
+  }
+
+  std::filesystem::create_directories(joinTreeCacheDir);
+  filePath = (std::filesystem::path(joinTreeCacheDir) / (getStructureKey(cnf) + ".jt")).string();
+  storingFlag = projectedCounting || cnf.shownVars.empty(); // cached join trees must respect shown vars for projected counting
+
+  std::ifstream inputFileStream(filePath);
+  string line;
+  while (getline(inputFileStream, line)) {
+    vector<string> words = util::splitInputLine(line);
+    if (words.size() == 3 && words.at(0) == "c" && words.at(1) == "joinTreeWidth") {
+      cachedWidth = stoll(words.at(2));
+    }
+  }
+
+  if (hasJoinTree()) {
+    cout << "c found cached join tree of width " << cachedWidth << " in file " << filePath << "\n";
+  }
+  else {
+    cout << "c found no cached join tree in file " << filePath << "\n";
+  }
+  if (!storingFlag) {
+    cout << "c will not store join trees, which may ignore shown vars without projected counting\n";
+  }
+}
+
+/* classes for compiled diagrams =========================================== */
+
+/* class WeightlessDd ======================================================= */
+
+vector<Number> WeightlessDd::getFullAbstractions(const vector<Int>& ddVarToCnfVarMap, const vector<const Map<Int, Number>*>& laneLiteralWeights, const vector<bool>& additiveFlags) const {
+  auto multiply = [](Float a, Float b) { return logCounting ? a + b : a * b; };
+  auto combine = [](Float a, Float b, bool additiveFlag) { // like Dd::getSum or Dd::getMax on terminals
+    if (!additiveFlag) {
+      return max(a, b);
+    }
+    if (!logCounting) {
+      return a + b;
+    }
+    if (a == -INF || b == -INF) { // zero terminals are common in clause products
+      return max(a, b);
+    }
+    return max(a, b) + log10l(1 + exp10l(min(a, b) - max(a, b)));
+  };
+
+  Int laneCount = laneLiteralWeights.size(); // values of lane k are at index * laneCount + k
+  Int levelCount = levelDdVars.size();
+  vector<Float> positiveWeights(levelCount * laneCount);
+  vector<Float> negativeWeights(levelCount * laneCount);
+  vector<bool> levelAdditiveFlags(levelCount);
+  vector<Float> skipFactors((levelCount + 1) * laneCount, logCounting ? 0 : 1); // projected weights of levels above index, for levels skipped by edges
+  for (Int level = 0; level < levelCount; level++) {
+    Int ddVar = levelDdVars.at(level);
+    Int cnfVar = ddVarToCnfVarMap.at(ddVar);
+    levelAdditiveFlags.at(level) = additiveFlags.at(ddVar);
+    for (Int lane = 0; lane < laneCount; lane++) {
+      const Map<Int, Number>& literalWeights = *laneLiteralWeights.at(lane);
+      Int i = level * laneCount + lane;
+      positiveWeights.at(i) = logCounting ? literalWeights.at(cnfVar).getLog10() : literalWeights.at(cnfVar).fraction;
+      negativeWeights.at(i) = logCounting ? literalWeights.at(-cnfVar).getLog10() : literalWeights.at(-cnfVar).fraction;
+      skipFactors.at(i + laneCount) = multiply(skipFactors.at(i), combine(positiveWeights.at(i), negativeWeights.at(i), levelAdditiveFlags.at(level)));
+    }
+  }
+  auto getSkipFactor = [&](Int fromLevel, Int toLevel, Int lane) { // weights are positive
+    Float toFactor = skipFactors[toLevel * laneCount + lane];
+    Float fromFactor = skipFactors[fromLevel * laneCount + lane];
+    return logCounting ? toFactor - fromFactor : toFactor / fromFactor;
+  };
+
+  vector<Float> nodeValues(nodeLevels.size() * laneCount); // abstraction of levels from node down
+  for (Int node = 0; node < nodeLevels.size(); node++) { // node structure is read once for all lanes
+    Int level = nodeLevels[node];
+    Float* values = &nodeValues[node * laneCount];
+    if (level == levelCount) {
+      std::fill(values, values + laneCount, terminalValues[node]);
+      continue;
+    }
+    Int highNode = highNodes[node];
+    Int lowNode = lowNodes[node];
+    const Float* highValues = &nodeValues[highNode * laneCount];
+    const Float* lowValues = &nodeValues[lowNode * laneCount];
+    const Float* levelPositiveWeights = &positiveWeights[level * laneCount];
+    const Float* levelNegativeWeights = &negativeWeights[level * laneCount];
+    bool additiveFlag = levelAdditiveFlags[level];
+    for (Int lane = 0; lane < laneCount; lane++) {
+      Float highValue = multiply(highValues[lane], getSkipFactor(level + 1, nodeLevels[highNode], lane));
+      Float lowValue = multiply(lowValues[lane], getSkipFactor(level + 1, nodeLevels[lowNode], lane));
+      values[lane] = combine(multiply(levelPositiveWeights[lane], highValue), multiply(levelNegativeWeights[lane], lowValue), additiveFlag);
+    }
+  }
+
+  vector<Number> solutions;
+  Int root = nodeLevels.size() - 1;
+  for (Int lane = 0; lane < laneCount; lane++) {
+    solutions.push_back(Number(multiply(getSkipFactor(0, nodeLevels.back(), lane), nodeValues[root * laneCount + lane])));
+  }
+  return solutions;
+}
+
+/* class CompiledCnf ======================================================== */
+
+vector<bool> CompiledCnf::getAdditiveFlags(bool maximizationFlag) const {
+  vector<bool> additiveFlags;
+  Int lowestOuterLevel = -1;
+  Int highestInnerLevel = dd.levelDdVars.size();
+  for (Int level = 0; level < dd.levelDdVars.size(); level++) {
+    Int cnfVar = ddVarToCnfVarMap.at(dd.levelDdVars.at(level));
+    if (cnf.outerVars.contains(cnfVar)) {
+      lowestOuterLevel = level;
+    }
+    else {
+      highestInnerLevel = min(highestInnerLevel, level);
+    }
+  }
+  for (Int cnfVar : ddVarToCnfVarMap) {
+    additiveFlags.push_back(!maximizationFlag && cnf.outerVars.contains(cnfVar) != existRandomFlag);
+  }
+  if (!maximizationFlag && highestInnerLevel < lowestOuterLevel) {
+    throw MyError("inner var at level ", highestInnerLevel, " is above outer var at level ", lowestOuterLevel, "; one-pass projection needs inner vars at lower levels");
+  }
+  return additiveFlags;
+}
+
+Number CompiledCnf::getAdjustedSolution(const Number& apparentSolution, const Map<Int, Number>& literalWeights, bool maximizationFlag) const {
+  Number n = apparentSolution;
+  for (Int var = 1; var <= cnf.declaredVarCount; var++) {
+    if (cnf.apparentVars.contains(var)) {
+      continue;
+    }
+    const Number& positiveWeight = literalWeights.at(var);
+    const Number& negativeWeight = literalWeights.at(-var);
+    Number factor = !maximizationFlag && cnf.outerVars.contains(var) != existRandomFlag ? positiveWeight + negativeWeight : max(positiveWeight, negativeWeight);
+    n = logCounting ? n + factor.getLog10() : n * factor; // like Executor::adjustSolutionToHiddenVar
+  }
+  return n;
+}
+
+vector<Number> CompiledCnf::getSolutions(const vector<const Map<Int, Number>*>& laneLiteralWeights, bool maximizationFlag) const {
+  vector<Number> solutions = dd.getFullAbstractions(ddVarToCnfVarMap, laneLiteralWeights, getAdditiveFlags(maximizationFlag));
+  for (Int lane = 0; lane < solutions.size(); lane++) {
+    solutions.at(lane) = getAdjustedSolution(solutions.at(lane), *laneLiteralWeights.at(lane), maximizationFlag);
+  }
+  return solutions;
+}
+
+void CompiledCnf::writeFile(string filePath) const {
+  std::ofstream outputFileStream(filePath, std::ios::binary);
+  auto writeArray = [&](const auto& v) { // count, then raw elements
+    Int count = v.size();
+    outputFileStream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    outputFileStream.write(reinterpret_cast<const char*>(v.data()), count * sizeof(v.front()));
+  };
+  auto writeWeights = [&](const Map<Int, Number>& weights) {
+    vector<Int> literals;
+    for (const auto& [literal, weight] : weights) {
+      literals.push_back(literal);
+    }
+    sort(literals.begin(), literals.end());
+    vector<Float> fractions;
+    for (Int literal : literals) {
+      fractions.push_back(weights.at(literal).fraction);
+    }
+    writeArray(literals);
+    writeArray(fractions);
+  };
+
+  outputFileStream << COMPILED_CNF_HEADER;
+  writeArray(vector<Int>{existRandomFlag, cnf.declaredVarCount});
+  writeArray(dd.levelDdVars);
+  writeArray(dd.nodeLevels);
+  writeArray(dd.highNodes);
+  writeArray(dd.lowNodes);
+  writeArray(dd.terminalValues);
+  writeArray(ddVarToCnfVarMap);
+  writeArray(util::getSortedNums(cnf.apparentVars));
+  writeArray(util::getSortedNums(cnf.outerVars));
+  writeWeights(cnf.originalLiteralWeights.empty() ? cnf.literalWeights : cnf.originalLiteralWeights);
+  vector<Int> substitutionLiterals; // flattened pairs
+  for (auto [var, literal] : cnf.substitutions) {
+    substitutionLiterals.push_back(var);
+    substitutionLiterals.push_back(literal);
+  }
+  writeArray(substitutionLiterals);
+
+  if (!outputFileStream) {
+    throw MyError("unable to write file '", filePath, "'");
+  }
+}
+
+CompiledCnf::CompiledCnf(const WeightlessDd& dd, const vector<Int>& ddVarToCnfVarMap, bool existRandomFlag, const Cnf& cnf) : dd(dd), ddVarToCnfVarMap(ddVarToCnfVarMap), existRandomFlag(existRandomFlag) {
+  this->cnf.declaredVarCount = cnf.declaredVarCount;
+  this->cnf.apparentVars = cnf.apparentVars;
+  this->cnf.outerVars = cnf.outerVars;
+  this->cnf.literalWeights = cnf.literalWeights;
+  this->cnf.substitutions = cnf.substitutions;
+  this->cnf.originalLiteralWeights = cnf.originalLiteralWeights;
+}
+
+CompiledCnf::CompiledCnf(string filePath) {
+  int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+  if (fileDescriptor < 0) {
+    throw MyError("unable to open file '", filePath, "'");
+  }
+  size_t byteCount = std::filesystem::file_size(filePath);
+  void* mapping = byteCount > 0 ? mmap(nullptr, byteCount, PROT_READ, MAP_PRIVATE, fileDescriptor, 0) : MAP_FAILED;
+  close(fileDescriptor);
+  if (mapping == MAP_FAILED) {
+    throw MyError("unable to map file '", filePath, "'");
+  }
+
+  const char* bytes = static_cast<const char*>(mapping);
+  size_t offset = 0;
+  auto readBytes = [&](void* destination, size_t size) {
+    if (offset + size > byteCount) {
+      munmap(mapping, byteCount);
+      throw MyError("truncated compiled CNF file '", filePath, "'");
+    }
+    std::memcpy(destination, bytes + offset, size);
+    offset += size;
+  };
+  auto readArray = [&](auto& v) {
+    Int count;
+    readBytes(&count, sizeof(count));
+    if (count < 0 || static_cast<size_t>(count) > byteCount) {
+      munmap(mapping, byteCount);
+      throw MyError("corrupt compiled CNF file '", filePath, "'");
+    }
+    v.resize(count);
+    readBytes(v.data(), count * sizeof(v.front()));
+  };
+  auto readWeights = [&]() {
+    vector<Int> literals;
+    vector<Float> fractions;
+    readArray(literals);
+    readArray(fractions);
+    Map<Int, Number> weights;
+    for (Int i = 0; i < literals.size(); i++) {
+      weights[literals.at(i)] = Number(fractions.at(i));
+    }
+    return weights;
+  };
+
+  string header(COMPILED_CNF_HEADER.size(), ' ');
+  readBytes(header.data(), header.size());
+  if (header != COMPILED_CNF_HEADER) {
+    munmap(mapping, byteCount);
+    throw MyError("file '", filePath, "' is not a compiled CNF file");
+  }
+  vector<Int> flags;
+  readArray(flags);
+  existRandomFlag = flags.at(0);
+  cnf.declaredVarCount = flags.at(1);
+  readArray(dd.levelDdVars);
+  readArray(dd.nodeLevels);
+  readArray(dd.highNodes);
+  readArray(dd.lowNodes);
+  readArray(dd.terminalValues);
+  readArray(ddVarToCnfVarMap);
+  vector<Int> vars;
+  readArray(vars);
+  cnf.apparentVars = Set<Int>(vars.begin(), vars.end());
+  readArray(vars);
+  cnf.outerVars = Set<Int>(vars.begin(), vars.end());
+  cnf.originalLiteralWeights = readWeights();
+  vector<Int> substitutionLiterals;
+  readArray(substitutionLiterals);
+  for (Int i = 0; i + 1 < substitutionLiterals.size(); i += 2) {
+    cnf.substitutions.push_back({substitutionLiterals.at(i), substitutionLiterals.at(i + 1)});
+  }
+  munmap(mapping, byteCount);
+
+  cnf.literalWeights = cnf.getFoldedLiteralWeights({});
+  if (logCounting) {
+    for (Float& value : dd.terminalValues) {
+      value = log10l(value);
+    }
+  }
+}
+
 /* global functions ========================================================= */
 
 ostream& operator<<(ostream& stream, const Number& n) {
@@ -2,18 +2,28 @@
 
 /* inclusions =============================================================== */
 
+#include <atomic>
 #include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <poll.h>
 #include <queue>
 #include <random>
+#include <set>
 #include <signal.h>
+#include <sys/mman.h>
 #include <sys/time.h>
+#include <sys/wait.h>
 #include <thread>
+#include <unistd.h>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -23,6 +33,7 @@
 
 using std::cout;
 using std::greater;
+using std::istream;
 using std::istream_iterator;
 using std::left;
 using std::map;
@@ -58,16 +69,28 @@ const Int MAX_INT = std::numeric_limits<Int>::max();
 
 const string JOIN_TREE_WORD = "jt";
 const string ELIM_VARS_WORD = "e";
+const string BINARY_FRAME_WORD = "b"; // binary join tree: "b <byte count>" line, then varint payload, then "\n"
+const Int MAX_BINARY_FRAME_BYTES = Int(1) << 30; // larger byte counts are malformed rather than allocated
 
+const string COMPILED_CNF_HEADER = "DPOCCNF1"; // first bytes of files written by CompiledCnf::writeFile
 const string WARNING = "c MY_WARNING: ";
 const string DASH_LINE = "c ------------------------------------------------------------------\n";
 
 const string CNF_FILE_OPTION = "cf";
 const string PROJECTED_COUNTING_OPTION = "pc";
+const string LOG_COUNTING_OPTION = "lc";
+const string COMPILED_CNF_OPTION = "ca";
+const string WEIGHT_LANE_OPTION = "wl";
 const string DD_PACKAGE_OPTION = "dp";
 const string RANDOM_SEED_OPTION = "rs";
 const string VERBOSE_CNF_OPTION = "vc";
 const string VERBOSE_SOLVING_OPTION = "vs";
+const string JOIN_TREE_CACHE_OPTION = "jc";
+const string XOR_ELIMINATION_OPTION = "xe";
+const string PREPROCESSING_OPTION = "pp";
+const string COMPONENT_DECOMPOSITION_OPTION = "cd";
+
+const Int MAX_SPARSIFYING_PASSES = 4; // over all pairs of XOR rows
 
 /* diagram packages: */
 const string CUDD = "c";
@@ -124,10 +147,15 @@ const string INPUT_VERBOSITY_LEVELS = "0, " + to_string(PARSED_INPUT) + ", " + t
 
 extern bool weightedCounting;
 extern bool projectedCounting;
+extern bool logCounting; // Float values are log10 of weights and counts
 extern Int randomSeed; // for reproducibility
 extern bool multiplePrecision;
 extern Int verboseCnf; // 1: parsed CNF, 2: raw CNF too
 extern Int verboseSolving; // 0: solution, 1: parsed options too, 2: more info
+extern string joinTreeCacheDir; // empty: no join tree cache
+extern bool xorElimination; // GF(2) elimination over XOR clauses when CNF is read
+extern bool preprocessing; // units, equivalent literals, and subsumed clauses when CNF is read
+extern bool componentDecomposition; // connected components of primal graph are planned and executed separately
 
 extern TimePoint toolStartPoint;
 
@@ -146,6 +174,10 @@ namespace util {
   TimePoint getTimePoint();
   Float getDuration(TimePoint start); // in seconds
 
+  void appendVarint(string& bytes, Int num); // unsigned LEB128
+  Int readVarint(const string& bytes, size_t& pos); // advances `pos`
+  string getHashKey(const string& text); // FNV-1a hash as 16 hex digits
+
   vector<string> splitInputLine(string line);
   void printInputLine(string line, Int lineIndex);
 
@@ -232,6 +264,16 @@ public:
   UnsatSolverException();
 };
 
+class InconsistentXorException : public UnsatException {
+public:
+  InconsistentXorException();
+};
+
+class UnsatPreprocessorException : public UnsatException {
+public:
+  UnsatPreprocessorException();
+};
+
 class MyError : public std::exception {
 public:
   template<typename ... Ts> MyError(const Ts& ... args) { // en.cppreference.com/w/cpp/language/fold
@@ -306,15 +348,67 @@ public:
   Set<Int> getClauseVars() const;
 };
 
+class XorSystem { // GF(2) rows packed in 64-bit words; bit 0 of each row is parity (var 0 is unused)
+public:
+  Int wordCount;
+  vector<vector<uint64_t>> rows;
+
+  static bool hasBit(const vector<uint64_t>& row, Int var);
+  static void flipBit(vector<uint64_t>& row, Int var);
+  static void addRow(vector<uint64_t>& row, const vector<uint64_t>& otherRow); // word-wise XOR, vectorized by compiler
+  static Int getRowVarCount(const vector<uint64_t>& row);
+  static Int getRowSpan(const vector<uint64_t>& row); // max var - min var
+
+  Int getLiteralCount() const;
+  Int getSpanSum() const; // proxy for locality of XOR clauses in primal graph
+  Clause getClause(const vector<uint64_t>& row) const; // negates first literal if parity is even
+  vector<Int> reduce(); // Gauss-Jordan; drops dependent rows and returns indices of kept rows
+  void sparsify(); // greedily replaces rows with shorter sums of row pairs that span no more vars
+
+  XorSystem(const vector<Clause>& xorClauses, Int declaredVarCount);
+};
+
+class Assignment;
+class Cnf;
+
+class CnfPreprocessor { // keeps weighted (projected) count: removed vars get weights (w, 0) so that they are adjusted as hidden vars
+public:
+  Cnf& cnf;
+  vector<bool> removedFlags; // clause index |-> whether clause is satisfied or subsumed
+  Map<Int, Set<Int>> varToClauseIndices; // among clauses that are not removed
+  std::queue<Int> unitLiterals;
+  Map<Int, Int> replacedVars; // var |-> equivalent literal
+  Set<Int> fixedLiterals;
+
+  Int propagatedUnitCount = 0;
+  Int substitutedVarCount = 0;
+  Int subsumedClauseCount = 0;
+
+  Int getRepresentative(Int literal) const; // follows replacedVars
+  void removeClause(Int clauseIndex);
+  void finishClause(Int clauseIndex, bool parityFlip); // handles complementary literals, empty clauses, units, and XOR parity
+  void propagateUnits();
+  void fixLiteral(Int literal);
+  void replaceVar(Int var, Int literal); // var is equivalent to literal
+  bool substituteEquivalences(); // from binary clauses and 2-XORs; returns false if none is found
+  void removeSubsumedClauses(); // also duplicates
+
+  CnfPreprocessor(Cnf& cnf); // throws UnsatPreprocessorException
+};
+
 class Cnf {
 public:
   vector<Clause> clauses;
   Int declaredVarCount = 0;
   Set<Int> apparentVars; // as opposed to hidden vars that are declared but appear in no clause
   Set<Int> outerVars;
+  Set<Int> shownVars; // from show lines, even without projected counting
   Map<Int, Number> literalWeights;
   Map<Int, Set<Int>> varToClauses; // var |-> clause indices
 
+  vector<pair<Int, Int>> substitutions; // (literal, 0) if literal was propagated; (var, literal) if var was replaced by equivalent literal
+  Map<Int, Number> originalLiteralWeights; // before preprocessing folds weights of removed vars
+
   void printClauses() const;
   void printLiteralWeights() const;
   Set<Int> getInnerVars() const;
@@ -322,6 +416,7 @@ public:
   void addClause(const Clause& clause);
   void setApparentVars();
   Graph getPrimalGraph() const;
+  vector<Int> getVarComponents() const; // var |-> representative var of connected component (0 if var is hidden)
   vector<Int> getRandomVarOrder() const;
   vector<Int> getDeclarationVarOrder() const;
   vector<Int> getMostClausesVarOrder() const;
@@ -335,6 +430,12 @@ public:
   bool isMc21ShowLine(const vector<string> &words) const; // c p show <vars> [0]
 
   void completeLiteralWeights();
+  static void foldSubstitution(Map<Int, Number>& weights, pair<Int, Int> substitution); // moves weight of removed var to its equivalent literal
+  Map<Int, Number> getWeightUpdates(const vector<string>& words, Int lineIndex) const; // "{literal} {weight} ... 0"
+  Map<Int, Number> getFoldedLiteralWeights(const Map<Int, Number>& weightUpdates) const; // overrides weights before preprocessing, then replays substitutions
+  void eliminateXors(); // keeps solutions; throws InconsistentXorException
+  void extendAssignment(Assignment& assignment) const; // assigns hidden vars, including those removed by preprocessing
+  void writeFile(string filePath) const; // DIMACS with XOR clauses, weights, and show line
 
   Cnf(); // empty conjunction
   Cnf(string filePath);
@@ -370,6 +471,7 @@ public:
   Set<Int> projectionVars; // empty for JoinTerminal
   Set<Int> preProjectionVars; // set by constructor
 
+  static void clearStaticFields(); // re-initializes static fields without backup
   static void resetStaticFields(); // backs up and re-initializes static fields
   static void restoreStaticFields(); // from backup
 
@@ -403,8 +505,10 @@ public:
 
 class JoinNonterminal : public JoinNode {
 public:
-  void printNode(string startWord) const; // 1-indexing
-  void printSubtree(string startWord = "") const; // post-order traversal
+  void printNode(string startWord, ostream& outputStream = cout) const; // 1-indexing
+  void printSubtree(string startWord = "", ostream& outputStream = cout) const; // post-order traversal
+  void appendNodeBytes(string& bytes) const; // varints: index, child count, children, var count, vars (1-indexing)
+  void appendSubtreeBytes(string& bytes) const; // post-order traversal
 
   Int getWidth(const Assignment& assignment = Assignment()) const override;
 
@@ -422,6 +526,61 @@ public:
   );
 };
 
+class JoinTreeCache { // on-disk join trees keyed by CNF structure (clause vars and shown vars, not weights), like LG
+public:
+  string filePath; // empty if no cache dir
+  Int cachedWidth = MAX_INT; // MAX_INT if no cached join tree
+  bool storingFlag = true; // false if join trees may ignore shown vars (they are still read)
+
+  static string getStructureKey(const Cnf& cnf); // hash key of canonical text
+
+  bool hasJoinTree() const;
+  void printJoinTree() const; // copies cached file (text join tree then "c joinTreeWidth" and "c seconds" lines) to stdout
+  bool storeJoinTree( // returns false if cached join tree is at least as narrow
+    const JoinNonterminal* joinRoot,
+    Int declaredVarCount,
+    Int declaredClauseCount,
+    Int declaredNodeCount,
+    Int width,
+    Float plannerDuration
+  );
+
+  JoinTreeCache(const Cnf& cnf); // reads `joinTreeCacheDir`
+};
+
+/* classes for compiled diagrams =========================================== */
+
+class WeightlessDd { // clause product flattened with children before parents, for batch mode (dmc) and queries (dmq)
+public:
+  vector<Int> levelDdVars; // level |-> DD var
+  vector<Int> nodeLevels; // node |-> level, which is levelDdVars.size() for terminals
+  vector<Int> highNodes;
+  vector<Int> lowNodes;
+  vector<Float> terminalValues; // by node
+
+  vector<Number> getFullAbstractions( // projects all DD vars in one bottom-up pass per lane group; valid if vars projected first are at lower levels
+    const vector<Int>& ddVarToCnfVarMap,
+    const vector<const Map<Int, Number>*>& laneLiteralWeights, // one weight vector per lane
+    const vector<bool>& additiveFlags // by DD var
+  ) const;
+};
+
+class CompiledCnf { // weightless diagram with var maps, weights, and substitutions of preprocessed CNF; file is written by dmc and mapped by dmq
+public:
+  WeightlessDd dd; // linear terminal values in file; log10 after loading if logCounting
+  vector<Int> ddVarToCnfVarMap;
+  bool existRandomFlag = false; // outer vars are maximized and inner vars are summed, as in dmc
+  Cnf cnf; // no clauses
+
+  vector<bool> getAdditiveFlags(bool maximizationFlag) const; // by DD var; throws MyError if one pass is invalid
+  Number getAdjustedSolution(const Number& apparentSolution, const Map<Int, Number>& literalWeights, bool maximizationFlag) const; // for hidden vars
+  vector<Number> getSolutions(const vector<const Map<Int, Number>*>& laneLiteralWeights, bool maximizationFlag) const; // weights are folded
+  void writeFile(string filePath) const; // raw binary for this platform
+
+  CompiledCnf(const WeightlessDd& dd, const vector<Int>& ddVarToCnfVarMap, bool existRandomFlag, const Cnf& cnf);
+  CompiledCnf(string filePath); // maps file into memory
+};
+
 /* global functions ========================================================= */
 
 ostream& operator<<(ostream& stream, const Number& n);
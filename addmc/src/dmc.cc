@@ -2,22 +2,37 @@
 
 /* global vars ============================================================== */
 
+string weightFilePath;
+Int weightLaneCount;
+string compiledCnfPath;
+string marginalFilePath;
 bool existRandom;
 string ddPackage;
-bool logCounting;
+Float approximationTolerance;
 Float logBound;
 string thresholdModel;
 bool existPruning;
+Float localSearchDuration;
+bool upperBoundPruning;
+Int boundUpdating;
 Int maximizerFormat;
 bool maximizerVerification;
+Int maximizerExtraction;
 bool substitutionMaximization;
 Int threadCount;
 Int threadSliceCount;
+Int workerProcessCount;
 Float memSensitivity;
 Float maxMem;
+Float memoryGovernor;
+Int dynamicReordering;
+Int reorderingThreshold;
 string joinPriority;
+bool joinTreeOptimization;
+string checkpointJournalPath;
 Int verboseJoinTree;
 Int verboseProfiling;
+string profileFilePrefix;
 
 Int dotFileIndex = 1;
 
@@ -115,6 +130,61 @@ const JoinNonterminal* JoinTreeProcessor::getJoinTreeRoot() const {
   return joinTree->getJoinRoot();
 }
 
+void JoinTreeProcessor::startJoinTree(Int declaredVarCount, Int declaredClauseCount, Int declaredNodeCount) {
+  if (problemLineIndex != MIN_INT) {
+    throw MyError("multiple problem lines: ", problemLineIndex, " and ", lineIndex);
+  }
+  problemLineIndex = lineIndex;
+
+  if (declaredClauseCount != JoinNode::cnf.clauses.size()) { // else terminals would index wrong clauses
+    throw MyError("join tree has ", declaredClauseCount, " clauses, but CNF has ", JoinNode::cnf.clauses.size(), "; planner and executor must use the same --", PREPROCESSING_OPTION, " and --", XOR_ELIMINATION_OPTION, " | line ", lineIndex);
+  }
+
+  joinTree = new JoinTree(declaredVarCount, declaredClauseCount, declaredNodeCount);
+
+  for (Int terminalIndex = 0; terminalIndex < declaredClauseCount; terminalIndex++) {
+    joinTree->joinTerminals[terminalIndex] = new JoinTerminal();
+  }
+}
+
+void JoinTreeProcessor::addNonterminal(Int parentIndex, const vector<Int>& childIndices, const Set<Int>& projectionVars) {
+  if (problemLineIndex == MIN_INT) {
+    string message = "no problem line before internal node | line " + to_string(lineIndex);
+    if (joinTreeEndLineIndex != MIN_INT) {
+      message += " (previous join tree ends on line " + to_string(joinTreeEndLineIndex) + ")";
+    }
+    throw MyError(message);
+  }
+
+  if (parentIndex < joinTree->declaredClauseCount || parentIndex >= joinTree->declaredNodeCount) {
+    throw MyError("wrong internal-node index | line ", lineIndex);
+  }
+
+  vector<JoinNode*> children;
+  for (Int childIndex : childIndices) {
+    if (childIndex < 0 || childIndex >= parentIndex) {
+      throw MyError("child '", childIndex + 1, "' wrong | line ", lineIndex);
+    }
+    children.push_back(joinTree->getJoinNode(childIndex));
+  }
+
+  Int declaredVarCount = joinTree->declaredVarCount;
+  for (Int var : projectionVars) {
+    if (var <= 0 || var > declaredVarCount) {
+      throw MyError("var '", var, "' inconsistent with declared var count '", declaredVarCount, "' | line ", lineIndex);
+    }
+  }
+
+  JoinNonterminal* joinNonterminal = new JoinNonterminal(children, projectionVars, parentIndex);
+  for (Int var : projectionVars) { // join tree must match clause vars, which --xe can rewrite without changing clause count
+    if (!joinNonterminal->preProjectionVars.contains(var) || joinTree->projectedVars.contains(var)) {
+      throw MyError("var '", var, "' is projected at node ", parentIndex + 1, " but ", joinTree->projectedVars.contains(var) ? "was already projected" : "occurs in no unprojected clause below", "; planner and executor must use the same --", PREPROCESSING_OPTION, " and --", XOR_ELIMINATION_OPTION, " | line ", lineIndex);
+    }
+    joinTree->projectedVars.insert(var);
+  }
+  joinTree->joinNonterminals[parentIndex] = joinNonterminal;
+}
+
 void JoinTreeProcessor::processCommentLine(const vector<string>& words) {
   if (words.size() == 3) {
     string key = words.at(1);
@@ -136,11 +206,6 @@ void JoinTreeProcessor::processCommentLine(const vector<string>& words) {
 }
 
 void JoinTreeProcessor::processProblemLine(const vector<string>& words) {
-  if (problemLineIndex != MIN_INT) {
-    throw MyError("multiple problem lines: ", problemLineIndex, " and ", lineIndex);
-  }
-  problemLineIndex = lineIndex;
-
   if (words.size() != 5) {
     throw MyError("problem line ", lineIndex, " has ", words.size(), " words (should be 5)");
   }
@@ -150,32 +215,13 @@ void JoinTreeProcessor::processProblemLine(const vector<string>& words) {
     throw MyError("expected '", JOIN_TREE_WORD, "'; found '", jtWord, "' | line ", lineIndex);
   }
 
-  Int declaredVarCount = stoll(words.at(2));
-  Int declaredClauseCount = stoll(words.at(3));
-  Int declaredNodeCount = stoll(words.at(4));
-
-  joinTree = new JoinTree(declaredVarCount, declaredClauseCount, declaredNodeCount);
-
-  for (Int terminalIndex = 0; terminalIndex < declaredClauseCount; terminalIndex++) {
-    joinTree->joinTerminals[terminalIndex] = new JoinTerminal();
-  }
+  startJoinTree(stoll(words.at(2)), stoll(words.at(3)), stoll(words.at(4)));
 }
 
 void JoinTreeProcessor::processNonterminalLine(const vector<string>& words) {
-  if (problemLineIndex == MIN_INT) {
-    string message = "no problem line before internal node | line " + to_string(lineIndex);
-    if (joinTreeEndLineIndex != MIN_INT) {
-      message += " (previous join tree ends on line " + to_string(joinTreeEndLineIndex) + ")";
-    }
-    throw MyError(message);
-  }
-
   Int parentIndex = stoll(words.front()) - 1; // 0-indexing
-  if (parentIndex < joinTree->declaredClauseCount || parentIndex >= joinTree->declaredNodeCount) {
-    throw MyError("wrong internal-node index | line ", lineIndex);
-  }
 
-  vector<JoinNode*> children;
+  vector<Int> childIndices; // 0-indexing
   Set<Int> projectionVars;
   bool parsingElimVars = false;
   for (Int i = 1; i < words.size(); i++) {
@@ -183,25 +229,54 @@ void JoinTreeProcessor::processNonterminalLine(const vector<string>& words) {
     if (word == ELIM_VARS_WORD) {
       parsingElimVars = true;
     }
+    else if (parsingElimVars) {
+      projectionVars.insert(stoll(word));
+    }
     else {
-      Int num = stoll(word);
-      if (parsingElimVars) {
-        Int declaredVarCount = joinTree->declaredVarCount;
-        if (num <= 0 || num > declaredVarCount) {
-          throw MyError("var '", num, "' inconsistent with declared var count '", declaredVarCount, "' | line ", lineIndex);
-        }
-        projectionVars.insert(num);
-      }
-      else {
-        Int childIndex = num - 1; // 0-indexing
-        if (childIndex < 0 || childIndex >= parentIndex) {
-          throw MyError("child '", word, "' wrong | line ", lineIndex);
-        }
-        children.push_back(joinTree->getJoinNode(childIndex));
-      }
+      childIndices.push_back(stoll(word) - 1);
+    }
+  }
+  addNonterminal(parentIndex, childIndices, projectionVars);
+}
+
+void JoinTreeProcessor::processBinaryFrame(istream& inputStream, const vector<string>& words) {
+  if (words.size() != 2) {
+    throw MyError("binary frame line ", lineIndex, " has ", words.size(), " words (should be 2)");
+  }
+
+  Int byteCount = stoll(words.at(1));
+  if (byteCount < 0 || byteCount > MAX_BINARY_FRAME_BYTES) {
+    throw MyError("binary frame line ", lineIndex, " has byte count ", byteCount, " (should be between 0 and ", MAX_BINARY_FRAME_BYTES, ")");
+  }
+  string bytes(byteCount, '\0');
+  if (!inputStream.read(bytes.data(), byteCount)) {
+    throw MyError("binary frame on line ", lineIndex, " ends after ", inputStream.gcount(), " of ", byteCount, " bytes");
+  }
+  if (inputStream.peek() == '\n') { // frame terminator
+    inputStream.get();
+  }
+
+  size_t pos = 0;
+  Int declaredVarCount = util::readVarint(bytes, pos);
+  Int declaredClauseCount = util::readVarint(bytes, pos);
+  Int declaredNodeCount = util::readVarint(bytes, pos);
+  startJoinTree(declaredVarCount, declaredClauseCount, declaredNodeCount);
+
+  while (pos < bytes.size()) {
+    Int parentIndex = util::readVarint(bytes, pos) - 1; // 0-indexing
+
+    vector<Int> childIndices(util::readVarint(bytes, pos)); // 0-indexing
+    for (Int& childIndex : childIndices) {
+      childIndex = util::readVarint(bytes, pos) - 1;
+    }
+
+    Set<Int> projectionVars;
+    for (Int varCount = util::readVarint(bytes, pos); varCount > 0; varCount--) {
+      projectionVars.insert(util::readVarint(bytes, pos));
     }
+
+    addNonterminal(parentIndex, childIndices, projectionVars);
   }
-  joinTree->joinNonterminals[parentIndex] = new JoinNonterminal(children, projectionVars, parentIndex);
 }
 
 void JoinTreeProcessor::finishReadingJoinTree() {
@@ -212,6 +287,11 @@ void JoinTreeProcessor::finishReadingJoinTree() {
     cout << WARNING << "missing internal nodes (" << expectedNonterminalCount << " expected, " << nonterminalCount << " found) before current join tree ends on line " << lineIndex << "\n";
   }
   else {
+    Set<Int> unprojectedVars = joinTree->getJoinRoot()->getPostProjectionVars(); // with projections checked by addNonterminal, clause vars match
+    if (!unprojectedVars.empty()) {
+      throw MyError("join tree never projects ", unprojectedVars.size(), " clause var(s), such as '", *unprojectedVars.begin(), "'; planner and executor must use the same --", PREPROCESSING_OPTION, " and --", XOR_ELIMINATION_OPTION, " | line ", lineIndex);
+    }
+
     if (joinTree->width == MIN_INT) {
       joinTree->width = joinTree->getJoinRoot()->getWidth();
     }
@@ -227,17 +307,23 @@ void JoinTreeProcessor::finishReadingJoinTree() {
     }
 
     joinTreeEndLineIndex = lineIndex;
-    backupJoinTree = joinTree;
-    JoinNode::resetStaticFields();
+    if (!joinTreeCacheDir.empty() && backupJoinTree != nullptr && joinTree->width >= backupJoinTree->width) { // keeps narrower join tree, possibly cached
+      cout << "c kept previous join tree of width " << backupJoinTree->width << "\n";
+      JoinNode::clearStaticFields();
+    }
+    else {
+      backupJoinTree = joinTree;
+      JoinNode::resetStaticFields();
+    }
   }
 
   problemLineIndex = MIN_INT;
   joinTree = nullptr;
 }
 
-void JoinTreeProcessor::readInputStream() {
+void JoinTreeProcessor::readInputStream(istream& inputStream) {
   string line;
-  while (getline(std::cin, line)) {
+  while (getline(inputStream, line)) {
     lineIndex++;
 
     if (verboseJoinTree >= RAW_INPUT) {
@@ -260,6 +346,9 @@ void JoinTreeProcessor::readInputStream() {
     else if (words.front() == "p") { // problem line
       processProblemLine(words);
     }
+    else if (words.front() == BINARY_FRAME_WORD) { // problem line and nonterminal-node lines in one frame
+      processBinaryFrame(inputStream, words);
+    }
     else { // nonterminal-node line
       processNonterminalLine(words);
     }
@@ -268,20 +357,36 @@ void JoinTreeProcessor::readInputStream() {
   if (joinTree != nullptr) {
     finishReadingJoinTree();
   }
+}
 
-  if (!hasDisarmedTimer()) { // stdin ends before timer expires
-    cout << "c stdin ends before timer expires; disarming timer\n";
-    disarmTimer();
-  }
+void JoinTreeProcessor::readCachedJoinTree(const JoinTreeCache& joinTreeCache) {
+  cout << "c reading cached join tree...\n";
+  std::ifstream inputFileStream(joinTreeCache.filePath);
+  readInputStream(inputFileStream);
+
+  lineIndex = 0; // stdin line numbers
+  joinTreeEndLineIndex = MIN_INT;
 }
 
 JoinTreeProcessor::JoinTreeProcessor(Float plannerWaitDuration) {
   cout << "c procressing join tree...\n";
 
   armTimer(plannerWaitDuration);
+
+  JoinTreeCache joinTreeCache(JoinNode::cnf);
+  if (joinTreeCache.hasJoinTree()) {
+    readCachedJoinTree(joinTreeCache);
+  }
+  const JoinTree* cachedJoinTree = backupJoinTree;
+
   cout << "c getting join tree from stdin with " << plannerWaitDuration << "s timer (end input with 'enter' then 'ctrl d')\n";
 
-  readInputStream();
+  readInputStream(std::cin);
+
+  if (!hasDisarmedTimer()) { // stdin ends before timer expires
+    cout << "c stdin ends before timer expires; disarming timer\n";
+    disarmTimer();
+  }
 
   if (joinTree == nullptr) {
     if (backupJoinTree == nullptr) {
@@ -296,155 +401,863 @@ JoinTreeProcessor::JoinTreeProcessor(Float plannerWaitDuration) {
   if (plannerPid != MIN_INT) { // timer expires before first join tree ends
     killPlanner();
   }
+
+  if (joinTree != cachedJoinTree) { // static fields (for JoinNode::isTerminal) have been restored
+    joinTreeCache.storeJoinTree(joinTree->getJoinRoot(), joinTree->declaredVarCount, joinTree->declaredClauseCount, joinTree->declaredNodeCount, joinTree->width, joinTree->plannerDuration);
+  }
 }
 
-/* classes for execution ==================================================== */
+/* class JoinTreeDraft ====================================================== */
 
-/* class SatSolver ========================================================== */
+bool JoinTreeDraft::isOuterVar(Int var) {
+  return JoinNode::cnf.outerVars.contains(var);
+}
 
-bool SatSolver::checkSat(bool exceptionThrowing) {
-  lbool satisfiability = cmsat.solve();
-  if (satisfiability == l_False) {
-    if (exceptionThrowing) {
-      throw UnsatSolverException();
+bool JoinTreeDraft::haveSameQuantifier(const Set<Int>& vars1, const Set<Int>& vars2) {
+  Set<Int> vars = vars1;
+  util::unionize(vars, vars2);
+  if (vars.empty()) {
+    return true;
+  }
+
+  bool outerFlag = isOuterVar(*vars.begin());
+  for (Int var : vars) {
+    if (isOuterVar(var) != outerFlag) {
+      return false;
     }
-    return false;
   }
-  assert(satisfiability == l_True);
   return true;
 }
 
-Assignment SatSolver::getModel() {
-  vector<Lit> banLits;
-  Assignment model;
-  vector<lbool> lbools = cmsat.get_model();
-  for (Int i = 0; i < lbools.size(); i++) {
-    Int cnfVar = i + 1;
-    bool val = true;
-    lbool b = lbools.at(i);
-    if (b != CMSat::l_Undef) {
-      assert(b == l_True || b == l_False);
-      val = b == l_True;
-      banLits.push_back(getLit(cnfVar, !val));
-    }
-    cmsat.add_clause(banLits);
-    model[cnfVar] = val;
+Int JoinTreeDraft::addNode(JoinNode* terminal, const vector<Int>& childIndices, const Set<Int>& projections) {
+  Set<Int> vars;
+  if (terminal != nullptr) {
+    vars = terminal->preProjectionVars;
   }
-  return model;
+  for (Int child : childIndices) {
+    util::unionize(vars, getPostProjectionVars(child));
+  }
+
+  terminals.push_back(terminal);
+  children.push_back(childIndices);
+  projectionVars.push_back(projections);
+  preProjectionVars.push_back(vars);
+  return terminals.size() - 1;
 }
 
-Lit SatSolver::getLit(Int cnfVar, bool val) {
-  assert(cnfVar > 0);
-  return Lit(cnfVar - 1, !val);
+Int JoinTreeDraft::importSubtree(const JoinNode* joinNode) {
+  vector<Int> childIndices;
+  for (JoinNode* child : joinNode->children) {
+    childIndices.push_back(child->isTerminal() ? addNode(child, vector<Int>(), Set<Int>()) : importSubtree(child));
+  }
+  return addNode(nullptr, childIndices, joinNode->projectionVars);
 }
 
-SatSolver::SatSolver(const Cnf& cnf) {
-  cmsat.new_vars(cnf.declaredVarCount);
-  for (const Clause& clause : cnf.clauses) {
-    if (clause.xorFlag) {
-      vector<unsigned> vars;
-      bool rhs = true;
-      for (Int literal : clause) {
-        vars.push_back(abs(literal) - 1);
-        if (literal < 0) {
-          rhs = !rhs;
-        }
-      }
-      cmsat.add_xor_clause(vars, rhs);
+bool JoinTreeDraft::isTerminal(Int index) const {
+  return terminals.at(index) != nullptr;
+}
+
+Set<Int> JoinTreeDraft::getPostProjectionVars(Int index) const {
+  return util::getDiff(preProjectionVars.at(index), projectionVars.at(index));
+}
+
+vector<Int> JoinTreeDraft::getPostOrder() const {
+  vector<Int> postOrder;
+  vector<pair<Int, size_t>> stack{{root, 0}}; // node index, next child position
+  while (!stack.empty()) {
+    auto& [index, childPosition] = stack.back();
+    if (childPosition < children.at(index).size()) {
+      Int child = children.at(index).at(childPosition++);
+      stack.push_back({child, 0});
     }
     else {
-      vector<Lit> lits;
-      for (Int literal : clause) {
-        lits.push_back(getLit(abs(literal), literal > 0));
-      }
-      cmsat.add_clause(lits);
+      postOrder.push_back(index);
+      stack.pop_back();
     }
   }
+  return postOrder;
 }
 
-/* class Dd ================================================================= */
-
-Float Dd::pruningDuration;
-
-Dd::Dd(const ADD& cuadd) {
-  assert(ddPackage == CUDD);
-  this->cuadd = cuadd;
+Int JoinTreeDraft::getWidth() const {
+  Int width = 0;
+  for (Int index : getPostOrder()) {
+    width = max(width, static_cast<Int>(preProjectionVars.at(index).size()));
+  }
+  return width;
 }
 
-Dd::Dd(const Mtbdd& mtbdd) {
-  assert(ddPackage == SYLVAN);
-  this->mtbdd = mtbdd;
+Float JoinTreeDraft::getCost() const {
+  Float cost = 0;
+  for (Int index : getPostOrder()) {
+    if (!isTerminal(index)) {
+      Int operationCount = max(static_cast<Int>(children.at(index).size()) - 1, 0ll) + projectionVars.at(index).size();
+      cost += operationCount * exp2l(preProjectionVars.at(index).size());
+    }
+  }
+  return cost;
 }
 
-Dd::Dd(const Dd& dd) {
-  if (ddPackage == CUDD) {
-    this->cuadd = dd.cuadd;
-  }
-  else {
-    this->mtbdd = dd.mtbdd;
+void JoinTreeDraft::flatten() {
+  for (Int index : getPostOrder()) {
+    if (!isTerminal(index)) {
+      vector<Int> flatChildren;
+      for (Int child : children.at(index)) {
+        if (!isTerminal(child) && projectionVars.at(child).empty()) { // product is associative
+          flatChildren.insert(flatChildren.end(), children.at(child).begin(), children.at(child).end());
+        }
+        else {
+          flatChildren.push_back(child);
+        }
+      }
+      children.at(index) = flatChildren;
+    }
   }
 }
 
-Number Dd::extractConst() const {
-  if (ddPackage == CUDD) {
-    ADD minTerminal = cuadd.FindMin();
-    assert(minTerminal == cuadd.FindMax());
-    return Number(cuddV(minTerminal.getNode()));
+void JoinTreeDraft::binarize(Int parent) {
+  vector<Int> nodes = children.at(parent);
+  if (nodes.size() <= 2) {
+    return;
   }
-  assert(mtbdd.isLeaf());
-  if (multiplePrecision) {
-    return Number(mpq_class((mpq_ptr)mtbdd_getvalue(mtbdd.GetMTBDD())));
+
+  Map<Int, Set<Int>> postProjectionVars; // remaining node |-> vars
+  Map<Int, Int> projectionVarCounts; // projection var of parent |-> number of remaining nodes containing var
+  for (Int node : nodes) {
+    postProjectionVars[node] = getPostProjectionVars(node);
+    for (Int var : postProjectionVars.at(node)) {
+      if (projectionVars.at(parent).contains(var)) {
+        projectionVarCounts[var]++;
+      }
+    }
+  }
+  auto isLocalVar = [&](Int var) { // in one remaining node, so projected below parent
+    return projectionVarCounts.contains(var) && projectionVarCounts.at(var) == 1;
+  };
+  for (Int node : nodes) { // else vars projected by parent accumulate in new nodes, and pair sizes cost linear time in fan-in
+    std::erase_if(postProjectionVars.at(node), isLocalVar);
+  }
+  bool pushingFlag = haveSameQuantifier(projectionVars.at(parent), Set<Int>()); // else inner vars must stay projected before outer vars
+
+  auto getPairSize = [&](Int node1, Int node2) { // var count after vars local to pair are pushed down
+    const Set<Int>& vars1 = postProjectionVars.at(node1);
+    const Set<Int>& vars2 = postProjectionVars.at(node2);
+    Set<Int> vars = vars1;
+    util::unionize(vars, vars2);
+
+    Int size = vars.size();
+    for (Int var : vars) {
+      if (projectionVarCounts.contains(var) && projectionVarCounts.at(var) == vars1.contains(var) + vars2.contains(var)) {
+        size--;
+      }
+    }
+    return size;
+  };
+
+  Set<Int> remainingNodes(nodes.begin(), nodes.end());
+  Map<Int, Set<Int>> varNodes; // var |-> remaining nodes containing var
+  std::set<pair<Int, Int>> sizedNodes; // remaining nodes by var count, then index
+  auto addRemainingNode = [&](Int node) {
+    remainingNodes.insert(node);
+    for (Int var : postProjectionVars.at(node)) {
+      varNodes[var].insert(node);
+    }
+    sizedNodes.insert({postProjectionVars.at(node).size(), node});
+  };
+  auto eraseRemainingNode = [&](Int node) {
+    remainingNodes.erase(node);
+    for (Int var : postProjectionVars.at(node)) {
+      varNodes.at(var).erase(node);
+    }
+    sizedNodes.erase({postProjectionVars.at(node).size(), node});
+  };
+  for (Int node : nodes) {
+    addRemainingNode(node);
   }
-  return Number(mtbdd_getdouble(mtbdd.GetMTBDD()));
-}
 
-Dd Dd::getConstDd(const Number& n, const Cudd* mgr) {
-  if (ddPackage == CUDD) {
-    return logCounting ? Dd(mgr->constant(n.getLog10())) : Dd(mgr->constant(n.fraction));
+  auto getPartners = [&](Int node) { // remaining nodes other than node: all if few, else ones sharing vars and the smallest, so that candidates stay linear in fan-in
+    vector<Int> partners;
+    if (remainingNodes.size() <= MAX_PAIRING_PARTNERS) {
+      for (Int otherNode : remainingNodes) {
+        if (otherNode != node) {
+          partners.push_back(otherNode);
+        }
+      }
+      return partners;
+    }
+    Set<Int> partnerSet;
+    for (Int var : postProjectionVars.at(node)) {
+      for (auto it = varNodes.at(var).begin(); it != varNodes.at(var).end() && partnerSet.size() < MAX_PAIRING_PARTNERS; it++) {
+        if (*it != node) {
+          partnerSet.insert(*it);
+        }
+      }
+    }
+    Int smallCount = 0;
+    for (auto it = sizedNodes.begin(); it != sizedNodes.end() && smallCount < MAX_PAIRING_PARTNERS; it++) {
+      if (it->second != node) {
+        partnerSet.insert(it->second);
+        smallCount++;
+      }
+    }
+    return vector<Int>(partnerSet.begin(), partnerSet.end());
+  };
+
+  using Candidate = pair<Int, pair<Int, Int>>; // pair size, nodes
+  std::priority_queue<Candidate, vector<Candidate>, greater<Candidate>> candidates;
+  if (nodes.size() <= MAX_PAIRING_PARTNERS) {
+    for (Int i = 0; i < nodes.size(); i++) {
+      for (Int j = i + 1; j < nodes.size(); j++) {
+        candidates.push({getPairSize(nodes.at(i), nodes.at(j)), {nodes.at(i), nodes.at(j)}});
+      }
+    }
   }
-  if (multiplePrecision) {
-    mpq_t q; // C interface
-    mpq_init(q);
-    mpq_set(q, n.quotient.get_mpq_t());
-    Dd dd(Mtbdd(mtbdd_gmp(q)));
-    mpq_clear(q);
-    return dd;
+  else {
+    for (Int node : nodes) {
+      for (Int partner : getPartners(node)) {
+        candidates.push({getPairSize(node, partner), {min(node, partner), max(node, partner)}});
+      }
+    }
   }
-  return Dd(Mtbdd::doubleTerminal(n.fraction));
-}
 
-Dd Dd::getZeroDd(const Cudd* mgr) {
-  return getConstDd(Number(), mgr);
-}
+  while (remainingNodes.size() > 2) {
+    while (!candidates.empty() && (!remainingNodes.contains(candidates.top().second.first) || !remainingNodes.contains(candidates.top().second.second))) { // stale candidate
+      candidates.pop();
+    }
+    Int node1, node2;
+    if (candidates.empty()) { // partners of remaining nodes were all paired elsewhere
+      node1 = sizedNodes.begin()->second;
+      node2 = std::next(sizedNodes.begin())->second;
+    }
+    else {
+      std::tie(node1, node2) = candidates.top().second;
+      candidates.pop();
+    }
 
-Dd Dd::getOneDd(const Cudd* mgr) {
-  return getConstDd(Number("1"), mgr);
+    Set<Int> localVars; // projected at new node, as pushProjectionsDown would, so that vars do not accumulate in ancestors
+    for (Int var : postProjectionVars.at(node1)) {
+      if (postProjectionVars.at(node2).contains(var) && projectionVarCounts.contains(var)) {
+        projectionVarCounts.at(var)--;
+        if (pushingFlag && isLocalVar(var)) {
+          localVars.insert(var);
+          projectionVars.at(parent).erase(var);
+          preProjectionVars.at(parent).erase(var);
+        }
+      }
+    }
+    Int node = addNode(nullptr, vector<Int>{node1, node2}, localVars);
+    postProjectionVars[node] = getPostProjectionVars(node);
+    std::erase_if(postProjectionVars.at(node), isLocalVar);
+
+    eraseRemainingNode(node1);
+    eraseRemainingNode(node2);
+    for (Int otherNode : getPartners(node)) {
+      candidates.push({getPairSize(node, otherNode), {node, otherNode}});
+    }
+    addRemainingNode(node);
+  }
+
+  children.at(parent) = util::getSortedNums(remainingNodes);
 }
 
-Dd Dd::getVarDd(Int ddVar, bool val, const Cudd* mgr) {
-  if (ddPackage == CUDD) {
-    if (logCounting) {
-      return Dd(mgr->addLogVar(ddVar, val));
+void JoinTreeDraft::binarize() {
+  for (Int index : getPostOrder()) {
+    if (!isTerminal(index)) {
+      binarize(index);
     }
-    ADD d = mgr->addVar(ddVar);
-    return val ? Dd(d) : Dd(d.Cmpl());
   }
-  MTBDD d0 = getZeroDd(mgr).mtbdd.GetMTBDD();
-  MTBDD d1= getOneDd(mgr).mtbdd.GetMTBDD();
-  return val ? Dd(mtbdd_makenode(ddVar, d0, d1)) : Dd(mtbdd_makenode(ddVar, d1, d0));
 }
 
-const Cudd* Dd::newMgr(Float mem, Int threadIndex) {
-  assert(ddPackage == CUDD);
-  Cudd* mgr = new Cudd(
-    0, // init num of BDD vars
-    0, // init num of ZDD vars
+void JoinTreeDraft::pushProjectionsDown() {
+  vector<Int> postOrder = getPostOrder();
+  for (auto it = postOrder.rbegin(); it != postOrder.rend(); it++) { // parents before children
+    if (isTerminal(*it)) {
+      continue;
+    }
+    for (Int var : util::getSortedNums(projectionVars.at(*it))) {
+      Int node = *it;
+      while (true) {
+        Int target = MIN_INT;
+        Int containingChildCount = 0;
+        for (Int child : children.at(node)) {
+          if (preProjectionVars.at(child).contains(var)) {
+            target = child;
+            containingChildCount++;
+          }
+        }
+        if (containingChildCount != 1 || isTerminal(target) || !haveSameQuantifier(projectionVars.at(target), Set<Int>{var})) { // inner vars must be projected before outer vars
+          break;
+        }
+
+        projectionVars.at(node).erase(var);
+        preProjectionVars.at(node).erase(var);
+        projectionVars.at(target).insert(var);
+        node = target;
+      }
+    }
+  }
+}
+
+Int JoinTreeDraft::getContractedNode(Int index) {
+  if (isTerminal(index) || children.at(index).size() != 1) {
+    return index;
+  }
+
+  Int child = children.at(index).front();
+  if (projectionVars.at(index).empty()) {
+    return child;
+  }
+  if (!isTerminal(child) && haveSameQuantifier(projectionVars.at(index), projectionVars.at(child))) {
+    util::unionize(projectionVars.at(child), projectionVars.at(index));
+    return child;
+  }
+  return index;
+}
+
+void JoinTreeDraft::mergeChains() {
+  for (Int index : getPostOrder()) {
+    for (Int& child : children.at(index)) {
+      child = getContractedNode(child);
+    }
+  }
+
+  Int contractedRoot = getContractedNode(root);
+  if (!isTerminal(contractedRoot)) {
+    root = contractedRoot;
+  }
+}
+
+JoinTreeDraft JoinTreeDraft::getRerootedDraft(Int newRoot) const {
+  Map<Int, vector<Int>> neighbors;
+  Map<Int, Int> varOccurrenceCounts; // var |-> number of terminals containing var
+  for (Int index : getPostOrder()) {
+    for (Int child : children.at(index)) {
+      neighbors[index].push_back(child);
+      neighbors[child].push_back(index);
+    }
+    if (isTerminal(index)) {
+      for (Int var : preProjectionVars.at(index)) {
+        varOccurrenceCounts[var]++;
+      }
+    }
+  }
+
+  Map<Int, Int> parents{{newRoot, MIN_INT}};
+  vector<Int> preOrder;
+  vector<Int> stack{newRoot};
+  while (!stack.empty()) {
+    Int index = stack.back();
+    stack.pop_back();
+    preOrder.push_back(index);
+    for (Int neighbor : neighbors.at(index)) {
+      if (neighbor != parents.at(index)) {
+        parents[neighbor] = index;
+        stack.push_back(neighbor);
+      }
+    }
+  }
+
+  JoinTreeDraft draft;
+  Map<Int, Int> draftIndices; // index in *this |-> index in draft
+  Map<Int, Map<Int, Int>> openVarCounts; // nonterminal |-> unprojected var |-> number of terminals in subtree containing var
+  for (auto it = preOrder.rbegin(); it != preOrder.rend(); it++) { // children before parents
+    Int index = *it;
+    if (isTerminal(index)) {
+      draftIndices[index] = draft.addNode(terminals.at(index), vector<Int>(), Set<Int>());
+      continue;
+    }
+
+    vector<Int> draftChildren;
+    Map<Int, Int> varCounts;
+    for (Int neighbor : neighbors.at(index)) {
+      if (neighbor == parents.at(index) || !draftIndices.contains(neighbor)) { // skips former root that becomes childless
+        continue;
+      }
+      draftChildren.push_back(draftIndices.at(neighbor));
+      if (isTerminal(neighbor)) {
+        for (Int var : preProjectionVars.at(neighbor)) {
+          varCounts[var]++;
+        }
+      }
+      else {
+        for (auto [var, count] : openVarCounts.at(neighbor)) {
+          varCounts[var] += count;
+        }
+        openVarCounts.erase(neighbor);
+      }
+    }
+    if (draftChildren.empty()) {
+      continue;
+    }
+
+    Set<Int> projections; // at LCA of terminals containing var
+    for (auto [var, count] : varCounts) {
+      if (count == varOccurrenceCounts.at(var)) {
+        projections.insert(var);
+      }
+    }
+    for (Int var : projections) {
+      varCounts.erase(var);
+    }
+
+    draftIndices[index] = draft.addNode(nullptr, draftChildren, projections);
+    openVarCounts[index] = varCounts;
+  }
+
+  draft.root = draftIndices.at(newRoot);
+  draft.mergeChains();
+  return draft;
+}
+
+vector<Int> JoinTreeDraft::getRerootingCandidates() const {
+  multimap<size_t, Int, greater<size_t>> sizedNodes; // |preProjectionVars| |-> nonterminal
+  for (Int index : getPostOrder()) {
+    if (!isTerminal(index) && index != root) {
+      sizedNodes.insert({preProjectionVars.at(index).size(), index});
+    }
+  }
+
+  vector<Int> candidates;
+  for (auto [size, index] : sizedNodes) {
+    if (candidates.size() == REROOTING_CANDIDATE_COUNT) {
+      break;
+    }
+    candidates.push_back(index);
+  }
+  return candidates;
+}
+
+JoinNonterminal* JoinTreeDraft::getJoinRoot() const {
+  Map<Int, JoinNode*> joinNodes;
+  for (Int index : getPostOrder()) {
+    if (isTerminal(index)) {
+      joinNodes[index] = terminals.at(index);
+    }
+    else {
+      vector<JoinNode*> childNodes;
+      for (Int child : children.at(index)) {
+        childNodes.push_back(joinNodes.at(child));
+      }
+      joinNodes[index] = new JoinNonterminal(childNodes, projectionVars.at(index));
+    }
+  }
+  return static_cast<JoinNonterminal*>(joinNodes.at(root));
+}
+
+const JoinNonterminal* JoinTreeDraft::getOptimizedJoinRoot(const JoinNonterminal* joinRoot) {
+  cout << "c optimizing join tree...\n";
+  TimePoint optimizationStartPoint = util::getTimePoint();
+
+  map<string, JoinTreeDraft> drafts;
+  drafts[ORIGINAL_VARIANT] = JoinTreeDraft(joinRoot);
+
+  drafts[BINARIZED_VARIANT] = drafts.at(ORIGINAL_VARIANT);
+  drafts.at(BINARIZED_VARIANT).binarize();
+
+  drafts[FLATTENED_VARIANT] = drafts.at(ORIGINAL_VARIANT);
+  drafts.at(FLATTENED_VARIANT).flatten();
+  drafts.at(FLATTENED_VARIANT).binarize();
+
+  for (string variant : {BINARIZED_VARIANT, FLATTENED_VARIANT}) {
+    drafts.at(variant).pushProjectionsDown();
+    drafts.at(variant).mergeChains();
+  }
+
+  if (haveSameQuantifier(JoinNode::cnf.apparentVars, Set<Int>())) { // projections can be placed at LCAs under any root
+    const JoinTreeDraft& baseDraft = drafts.at(BINARIZED_VARIANT).getCost() <= drafts.at(FLATTENED_VARIANT).getCost() ? drafts.at(BINARIZED_VARIANT) : drafts.at(FLATTENED_VARIANT);
+    JoinTreeDraft bestDraft = baseDraft;
+    for (Int candidate : baseDraft.getRerootingCandidates()) {
+      JoinTreeDraft rerootedDraft = baseDraft.getRerootedDraft(candidate);
+      if (rerootedDraft.getCost() < bestDraft.getCost()) {
+        bestDraft = rerootedDraft;
+      }
+    }
+    drafts[REROOTED_VARIANT] = bestDraft;
+  }
+
+  string bestVariant = ORIGINAL_VARIANT;
+  for (const auto& [variant, draft] : drafts) {
+    Float cost = draft.getCost();
+    if (verboseSolving >= 1) {
+      util::printRow("joinTreeWidth_" + variant, draft.getWidth());
+      util::printRow("joinTreeCost_" + variant, cost);
+    }
+    if (cost < drafts.at(bestVariant).getCost()) {
+      bestVariant = variant;
+    }
+  }
+
+  const JoinTreeDraft& bestDraft = drafts.at(bestVariant);
+  const JoinNonterminal* optimizedJoinRoot = bestVariant == ORIGINAL_VARIANT ? joinRoot : bestDraft.getJoinRoot();
+
+  util::printRow("joinTreeVariant", bestVariant);
+  util::printRow("estimatedPeakDiagramSize", exp2l(bestDraft.getWidth()));
+  util::printRow("joinTreeOptimizationSeconds", util::getDuration(optimizationStartPoint));
+
+  if (verboseJoinTree >= PARSED_INPUT && bestVariant != ORIGINAL_VARIANT) {
+    cout << DASH_LINE;
+    optimizedJoinRoot->printSubtree("c ");
+    cout << DASH_LINE;
+  }
+
+  return optimizedJoinRoot;
+}
+
+JoinTreeDraft::JoinTreeDraft(const JoinNonterminal* joinRoot) {
+  root = importSubtree(joinRoot);
+}
+
+JoinTreeDraft::JoinTreeDraft() {}
+
+/* classes for execution ==================================================== */
+
+/* class SatSolver ========================================================== */
+
+bool SatSolver::checkSat(bool exceptionThrowing) {
+  lbool satisfiability = cmsat.solve();
+  if (satisfiability == l_False) {
+    if (exceptionThrowing) {
+      throw UnsatSolverException();
+    }
+    return false;
+  }
+  assert(satisfiability == l_True);
+  return true;
+}
+
+Assignment SatSolver::getModel() {
+  vector<Lit> banLits;
+  Assignment model;
+  vector<lbool> lbools = cmsat.get_model();
+  for (Int i = 0; i < lbools.size(); i++) {
+    Int cnfVar = i + 1;
+    bool val = true;
+    lbool b = lbools.at(i);
+    if (b != CMSat::l_Undef) {
+      assert(b == l_True || b == l_False);
+      val = b == l_True;
+      banLits.push_back(getLit(cnfVar, !val));
+    }
+    model[cnfVar] = val;
+  }
+  cmsat.add_clause(banLits);
+  return model;
+}
+
+Lit SatSolver::getLit(Int cnfVar, bool val) {
+  assert(cnfVar > 0);
+  return Lit(cnfVar - 1, !val);
+}
+
+SatSolver::SatSolver(const Cnf& cnf) {
+  cmsat.new_vars(cnf.declaredVarCount);
+  for (const Clause& clause : cnf.clauses) {
+    if (clause.xorFlag) {
+      vector<unsigned> vars;
+      bool rhs = true;
+      for (Int literal : clause) {
+        vars.push_back(abs(literal) - 1);
+        if (literal < 0) {
+          rhs = !rhs;
+        }
+      }
+      cmsat.add_xor_clause(vars, rhs);
+    }
+    else {
+      vector<Lit> lits;
+      for (Int literal : clause) {
+        lits.push_back(getLit(abs(literal), literal > 0));
+      }
+      cmsat.add_clause(lits);
+    }
+  }
+}
+
+/* class LocalSearcher ====================================================== */
+
+bool LocalSearcher::isSatisfied(Int clauseIndex) const {
+  Int count = trueLiteralCounts.at(clauseIndex);
+  return cnf.clauses.at(clauseIndex).xorFlag ? count % 2 == 1 : count > 0;
+}
+
+Float LocalSearcher::getLogWeightGain(Int var) const {
+  Float gain = vals.at(var) ? negativeLogWeights.at(var) - positiveLogWeights.at(var) : positiveLogWeights.at(var) - negativeLogWeights.at(var);
+  return std::isnan(gain) ? 0 : gain; // both weights 0
+}
+
+Int LocalSearcher::getBreakCount(Int var) const {
+  Int breakCount = 0;
+  if (!cnf.varToClauses.contains(var)) {
+    return breakCount;
+  }
+  for (Int clauseIndex : cnf.varToClauses.at(var)) {
+    if (!isSatisfied(clauseIndex)) {
+      continue;
+    }
+    if (cnf.clauses.at(clauseIndex).xorFlag) {
+      breakCount++;
+    }
+    else if (trueLiteralCounts.at(clauseIndex) == 1 && cnf.clauses.at(clauseIndex).contains(vals.at(var) ? var : -var)) {
+      breakCount++;
+    }
+  }
+  return breakCount;
+}
+
+void LocalSearcher::flipVar(Int var) {
+  logWeight += getLogWeightGain(var);
+  vals[var] = !vals.at(var);
+  if (!cnf.varToClauses.contains(var)) {
+    return;
+  }
+  for (Int clauseIndex : cnf.varToClauses.at(var)) {
+    const Clause& clause = cnf.clauses.at(clauseIndex);
+    bool satisfiedFlag = isSatisfied(clauseIndex);
+    if (clause.contains(var)) {
+      trueLiteralCounts[clauseIndex] += vals.at(var) ? 1 : -1;
+    }
+    if (clause.contains(-var)) {
+      trueLiteralCounts[clauseIndex] += vals.at(var) ? -1 : 1;
+    }
+    if (satisfiedFlag && !isSatisfied(clauseIndex)) {
+      unsatPositions[clauseIndex] = unsatClauseIndices.size();
+      unsatClauseIndices.push_back(clauseIndex);
+    }
+    else if (!satisfiedFlag && isSatisfied(clauseIndex)) { // swaps with last unsatisfied clause
+      Int position = unsatPositions.at(clauseIndex);
+      Int lastClauseIndex = unsatClauseIndices.back();
+      unsatClauseIndices[position] = lastClauseIndex;
+      unsatPositions[lastClauseIndex] = position;
+      unsatClauseIndices.pop_back();
+      unsatPositions[clauseIndex] = -1;
+    }
+  }
+}
+
+Int LocalSearcher::pickVarInUnsatClause() {
+  Int clauseIndex = unsatClauseIndices.at(generator() % unsatClauseIndices.size());
+  vector<Int> vars;
+  for (Int literal : cnf.clauses.at(clauseIndex)) {
+    vars.push_back(abs(literal));
+  }
+  if (std::uniform_real_distribution<Float>(0, 1)(generator) < LOCAL_SEARCH_NOISE) {
+    return vars.at(generator() % vars.size());
+  }
+
+  Int bestVar = vars.front();
+  Int bestBreakCount = MAX_INT;
+  Float bestGain = -INF;
+  for (Int var : vars) { // fewest broken clauses, then biggest weight gain
+    Int breakCount = getBreakCount(var);
+    Float gain = getLogWeightGain(var);
+    if (breakCount < bestBreakCount || (breakCount == bestBreakCount && gain > bestGain)) {
+      bestVar = var;
+      bestBreakCount = breakCount;
+      bestGain = gain;
+    }
+  }
+  return bestVar;
+}
+
+Int LocalSearcher::pickWeightGainingVar() {
+  for (Int sample = 0; sample < cnf.declaredVarCount; sample++) {
+    Int var = generator() % cnf.declaredVarCount + 1;
+    if (getLogWeightGain(var) > 0) {
+      return var;
+    }
+  }
+  return MIN_INT;
+}
+
+void LocalSearcher::search(Float duration, Assignment& bestModel, Float& bestLogWeight, mutex& bestMutex) {
+  TimePoint searchStartPoint = util::getTimePoint();
+  for (Int flipCount = 0; ; flipCount++) {
+    if (flipCount % LOCAL_SEARCH_CLOCK_PERIOD == 0 && util::getDuration(searchStartPoint) >= duration) {
+      return;
+    }
+
+    if (!unsatClauseIndices.empty()) {
+      flipVar(pickVarInUnsatClause());
+      continue;
+    }
+
+    {
+      const std::lock_guard<mutex> g(bestMutex);
+      if (logWeight > bestLogWeight) {
+        bestLogWeight = logWeight;
+        bestModel.clear();
+        for (Int var = 1; var <= cnf.declaredVarCount; var++) {
+          bestModel[var] = vals.at(var);
+        }
+      }
+    }
+
+    Int var = pickWeightGainingVar(); // leaves satisfied region for heavier models
+    flipVar(var == MIN_INT ? generator() % cnf.declaredVarCount + 1 : var);
+  }
+}
+
+LocalSearcher::LocalSearcher(const Cnf& cnf, Int seed) : cnf(cnf), generator(seed) {
+  positiveLogWeights.push_back(-INF); // var 0 is unused
+  negativeLogWeights.push_back(-INF);
+  vals.push_back(false);
+  for (Int var = 1; var <= cnf.declaredVarCount; var++) {
+    positiveLogWeights.push_back(cnf.literalWeights.at(var).getLog10());
+    negativeLogWeights.push_back(cnf.literalWeights.at(-var).getLog10());
+    vals.push_back(positiveLogWeights.back() >= negativeLogWeights.back());
+    logWeight += vals.back() ? positiveLogWeights.back() : negativeLogWeights.back();
+  }
+
+  for (Int clauseIndex = 0; clauseIndex < cnf.clauses.size(); clauseIndex++) {
+    Int count = 0;
+    for (Int literal : cnf.clauses.at(clauseIndex)) {
+      if (vals.at(abs(literal)) == (literal > 0)) {
+        count++;
+      }
+    }
+    trueLiteralCounts.push_back(count);
+    unsatPositions.push_back(-1);
+    if (!isSatisfied(clauseIndex)) {
+      unsatPositions.back() = unsatClauseIndices.size();
+      unsatClauseIndices.push_back(clauseIndex);
+    }
+  }
+}
+
+/* class Dd ================================================================= */
+
+Float Dd::pruningDuration;
+
+Dd::Dd(const ADD& cuadd) {
+  assert(ddPackage == CUDD);
+  this->cuadd = cuadd;
+}
+
+Dd::Dd(const Mtbdd& mtbdd) {
+  assert(ddPackage == SYLVAN);
+  this->mtbdd = mtbdd;
+}
+
+Dd::Dd(const Dd& dd) {
+  if (ddPackage == CUDD) {
+    this->cuadd = dd.cuadd;
+  }
+  else {
+    this->mtbdd = dd.mtbdd;
+  }
+  this->logErrorBound = dd.logErrorBound;
+}
+
+Number Dd::extractConst() const {
+  if (ddPackage == CUDD) {
+    ADD minTerminal = cuadd.FindMin();
+    assert(minTerminal == cuadd.FindMax());
+    return Number(cuddV(minTerminal.getNode()));
+  }
+  assert(mtbdd.isLeaf());
+  if (multiplePrecision) {
+    return Number(mpq_class((mpq_ptr)mtbdd_getvalue(mtbdd.GetMTBDD())));
+  }
+  return Number(mtbdd_getdouble(mtbdd.GetMTBDD()));
+}
+
+Dd Dd::getConstDd(const Number& n, const Cudd* mgr) {
+  if (ddPackage == CUDD) {
+    return logCounting ? Dd(mgr->constant(n.getLog10())) : Dd(mgr->constant(n.fraction));
+  }
+  if (multiplePrecision) {
+    mpq_t q; // C interface
+    mpq_init(q);
+    mpq_set(q, n.quotient.get_mpq_t());
+    Dd dd(Mtbdd(mtbdd_gmp(q)));
+    mpq_clear(q);
+    return dd;
+  }
+  return Dd(Mtbdd::doubleTerminal(n.fraction));
+}
+
+Dd Dd::getZeroDd(const Cudd* mgr) {
+  return getConstDd(Number(), mgr);
+}
+
+Dd Dd::getOneDd(const Cudd* mgr) {
+  return getConstDd(Number("1"), mgr);
+}
+
+Dd Dd::getVarDd(Int ddVar, bool val, const Cudd* mgr) {
+  if (ddPackage == CUDD) {
+    if (logCounting) {
+      return Dd(mgr->addLogVar(ddVar, val));
+    }
+    ADD d = mgr->addVar(ddVar);
+    return val ? Dd(d) : Dd(d.Cmpl());
+  }
+  MTBDD d0 = getZeroDd(mgr).mtbdd.GetMTBDD();
+  MTBDD d1= getOneDd(mgr).mtbdd.GetMTBDD();
+  return val ? Dd(mtbdd_makenode(ddVar, d0, d1)) : Dd(mtbdd_makenode(ddVar, d1, d0));
+}
+
+Int Dd::getVarLevel(Int ddVar, const Cudd* mgr) {
+  if (ddPackage == CUDD) {
+    mgr->addVar(ddVar);
+    return mgr->ReadPerm(ddVar);
+  }
+  return ddVar; // Sylvan keeps var order fixed
+}
+
+Dd Dd::getNodeDd(Int ddVar, const Dd& highDd, const Dd& lowDd, const Cudd* mgr) {
+  if (ddPackage == CUDD) {
+    if (highDd.cuadd == lowDd.cuadd) {
+      return highDd;
+    }
+    return Dd(ADD(*mgr, cuddUniqueInter(mgr->getManager(), ddVar, highDd.cuadd.getNode(), lowDd.cuadd.getNode()))); // children stay referenced by their wrappers
+  }
+  return Dd(Mtbdd(mtbdd_makenode(ddVar, lowDd.mtbdd.GetMTBDD(), highDd.mtbdd.GetMTBDD())));
+}
+
+Dd Dd::getClauseDd(const vector<pair<Int, bool>>& ddLiterals, bool xorFlag, bool parityFlag, const Cudd* mgr) {
+  Dd zeroDd = getZeroDd(mgr);
+  Dd oneDd = getOneDd(mgr);
+
+  if (!xorFlag) { // OR chain: each node is satisfied on its literal and falls through to lower literals otherwise
+    Dd dd = zeroDd;
+    for (const auto& [ddVar, val] : ddLiterals) {
+      dd = val ? getNodeDd(ddVar, oneDd, dd, mgr) : getNodeDd(ddVar, dd, oneDd, mgr);
+    }
+    return dd;
+  }
+
+  Dd evenDd = zeroDd; // XOR ladder: lower literals must have odd parity
+  Dd oddDd = oneDd; // lower literals must have even parity
+  for (const auto& [ddVar, val] : ddLiterals) {
+    Dd newEvenDd = val ? getNodeDd(ddVar, oddDd, evenDd, mgr) : getNodeDd(ddVar, evenDd, oddDd, mgr);
+    Dd newOddDd = val ? getNodeDd(ddVar, evenDd, oddDd, mgr) : getNodeDd(ddVar, oddDd, evenDd, mgr);
+    evenDd = newEvenDd;
+    oddDd = newOddDd;
+  }
+  return parityFlag ? oddDd : evenDd;
+}
+
+const Cudd* Dd::newMgr(Float mem, Int threadIndex) {
+  assert(ddPackage == CUDD);
+  size_t cacheSlots = CUDD_CACHE_SLOTS;
+  if (memoryGovernor > 0) { // else governed mem share can be taken by cache table alone
+    cacheSlots = std::min(cacheSlots, MemoryGovernor::getMaxCacheSlots(mem));
+  }
+  Cudd* mgr = new Cudd(
+    0, // init num of BDD vars
+    0, // init num of ZDD vars
     CUDD_UNIQUE_SLOTS, // init num of unique-table slots; cudd.h: #define CUDD_UNIQUE_SLOTS 256
-    CUDD_CACHE_SLOTS, // init num of cache-table slots; cudd.h: #define CUDD_CACHE_SLOTS 262144
+    cacheSlots, // init num of cache-table slots; cudd.h: #define CUDD_CACHE_SLOTS 262144
     mem * MEGA // maxMemory
   );
   mgr->getManager()->threadIndex = threadIndex;
+  if (dynamicReordering) {
+    mgr->SetNextReordering(reorderingThreshold); // triggered by Executor::reorderDdVars instead of autodyn
+  }
   mgr->getManager()->peakMemIncSensitivity = memSensitivity * MEGA; // makes CUDD print "c cuddMegabytes_{threadIndex + 1} {memused / 1e6}"
+  if (memoryGovernor > 0) {
+    MemoryGovernor::govern(mgr, mem);
+  }
   if (verboseSolving >= 3 && threadIndex == 0) {
     // util::printRow("hardMaxMemMegabytes", mgr->ReadMaxMemory() / MEGA); // for unique table and cache table combined (unlimited by default)
     // util::printRow("softMaxMemMegabytes", mgr->getManager()->maxmem / MEGA); // cuddInt.c: maxmem = maxMemory / 10 * 9
@@ -478,7 +1291,9 @@ bool Dd::operator<(const Dd& rightDd) const {
 Dd Dd::getComposition(Int ddVar, bool val, const Cudd* mgr) const {
   if (ddPackage == CUDD) {
     if (util::isFound(ddVar, cuadd.SupportIndices())) {
-      return Dd(cuadd.Compose(val ? mgr->addOne() : mgr->addZero(), ddVar));
+      Dd composition(cuadd.Compose(val ? mgr->addOne() : mgr->addZero(), ddVar));
+      composition.logErrorBound = logErrorBound;
+      return composition;
     }
     return *this;
   }
@@ -489,7 +1304,9 @@ Dd Dd::getComposition(Int ddVar, bool val, const Cudd* mgr) const {
 
 Dd Dd::getProduct(const Dd& dd) const {
   if (ddPackage == CUDD) {
-    return logCounting ? Dd(cuadd + dd.cuadd) : Dd(cuadd * dd.cuadd);
+    Dd product = logCounting ? Dd(cuadd + dd.cuadd) : Dd(cuadd * dd.cuadd);
+    product.logErrorBound = logErrorBound + dd.logErrorBound;
+    return product;
   }
   if (multiplePrecision) {
     LACE_ME;
@@ -500,7 +1317,9 @@ Dd Dd::getProduct(const Dd& dd) const {
 
 Dd Dd::getSum(const Dd& dd) const {
   if (ddPackage == CUDD) {
-    return logCounting ? Dd(cuadd.LogSumExp(dd.cuadd)) : Dd(cuadd + dd.cuadd);
+    Dd sum = logCounting ? Dd(cuadd.LogSumExp(dd.cuadd)) : Dd(cuadd + dd.cuadd);
+    sum.logErrorBound = max(logErrorBound, dd.logErrorBound); // terms are nonnegative
+    return sum;
   }
   if (multiplePrecision) {
     LACE_ME;
@@ -511,7 +1330,9 @@ Dd Dd::getSum(const Dd& dd) const {
 
 Dd Dd::getMax(const Dd& dd) const {
   if (ddPackage == CUDD) {
-    return Dd(cuadd.Maximum(dd.cuadd));
+    Dd maximum(cuadd.Maximum(dd.cuadd));
+    maximum.logErrorBound = max(logErrorBound, dd.logErrorBound);
+    return maximum;
   }
   if (multiplePrecision) {
     LACE_ME;
@@ -553,6 +1374,16 @@ bool Dd::evalAssignment(vector<int>& ddVarAssignment) const {
   return n == Number("1");
 }
 
+vector<int> Dd::getMaxCube(const Cudd* mgr) const {
+  assert(ddPackage == CUDD);
+  BDD maxBdd = cuadd.BddThreshold(cuddV(cuadd.FindMax().getNode()));
+  vector<char> cube(mgr->ReadSize(), 2);
+  if (!cube.empty()) {
+    maxBdd.PickOneCube(&cube.front());
+  }
+  return vector<int>(cube.begin(), cube.end());
+}
+
 Dd Dd::getAbstraction(Int ddVar, const vector<Int>& ddVarToCnfVarMap, const Map<Int, Number>& literalWeights, const Assignment& assignment, bool additiveFlag, vector<pair<Int, Dd>>& maximizationStack, const Cudd* mgr) const {
   Int cnfVar = ddVarToCnfVarMap.at(ddVar);
   Dd positiveWeight = getConstDd(literalWeights.at(cnfVar), mgr);
@@ -567,17 +1398,36 @@ Dd Dd::getAbstraction(Int ddVar, const vector<Int>& ddVarToCnfVarMap, const Map<
   Dd highTerm = getComposition(ddVar, true, mgr).getProduct(positiveWeight);
   Dd lowTerm = getComposition(ddVar, false, mgr).getProduct(negativeWeight);
 
-  if (maximizerFormat && !additiveFlag) {
+  if (maximizerFormat && maximizerExtraction == DERIVATIVE_SIGNS && !additiveFlag) {
     Dd dsgn = highTerm.getBoolDiff(lowTerm); // derivative sign
     maximizationStack.push_back({ddVar, dsgn});
     if (substitutionMaximization) {
-      return Dd(cuadd.Compose(dsgn.cuadd, ddVar));
+      Dd substitution(cuadd.Compose(dsgn.cuadd, ddVar));
+      substitution.logErrorBound = logErrorBound;
+      return substitution;
     }
   }
 
   return additiveFlag ? highTerm.getSum(lowTerm) : highTerm.getMax(lowTerm);
 }
 
+Dd Dd::getSumAbstraction(const vector<Int>& ddVars, const Cudd* mgr) const {
+  if (ddPackage == CUDD) {
+    ADD cube = mgr->addOne();
+    for (Int ddVar : ddVars) {
+      cube *= mgr->addVar(ddVar);
+    }
+    Dd abstraction = logCounting ? Dd(cuadd.LogExistAbstract(cube)) : Dd(cuadd.ExistAbstract(cube));
+    abstraction.logErrorBound = logErrorBound;
+    return abstraction;
+  }
+  sylvan::BddSet vars;
+  for (Int ddVar : ddVars) {
+    vars.add(ddVar);
+  }
+  return Dd(mtbdd.AbstractPlus(vars));
+}
+
 Dd Dd::getPrunedDd(Float lowerBound, const Cudd* mgr) const {
   assert(logCounting);
 
@@ -588,7 +1438,64 @@ Dd Dd::getPrunedDd(Float lowerBound, const Cudd* mgr) const {
 
   pruningDuration += util::getDuration(pruningStartPoint);
 
-  return Dd(prunedDd);
+  Dd dd(prunedDd);
+  dd.logErrorBound = logErrorBound;
+  return dd;
+}
+
+Dd Dd::getRoundedDd(Float logStep, const Cudd* mgr) const {
+  assert(logCounting);
+
+  Dd roundedDd(cuadd.LogRoundOff(mgr->constant(logStep)));
+  roundedDd.logErrorBound = logErrorBound;
+  if (roundedDd != *this) {
+    roundedDd.logErrorBound += logStep / 2; // nearest multiple
+  }
+  return roundedDd;
+}
+
+WeightlessDd Dd::getFlattenedDd(Int ddVarCount, const Cudd* mgr) const {
+  WeightlessDd flatDd;
+  flatDd.levelDdVars.resize(ddVarCount);
+  for (Int ddVar = 0; ddVar < ddVarCount; ddVar++) {
+    flatDd.levelDdVars.at(getVarLevel(ddVar, mgr)) = ddVar;
+  }
+
+  auto addFlatNode = [&](Int level, Int highNode, Int lowNode, Float terminalValue) {
+    flatDd.nodeLevels.push_back(level);
+    flatDd.highNodes.push_back(highNode);
+    flatDd.lowNodes.push_back(lowNode);
+    flatDd.terminalValues.push_back(terminalValue);
+    return static_cast<Int>(flatDd.nodeLevels.size() - 1);
+  };
+  if (ddPackage == CUDD) {
+    Map<DdNode*, Int> nodeIndices;
+    auto addNode = [&](auto& self, DdNode* ddNode) -> Int { // post-order, so root is last
+      auto it = nodeIndices.find(ddNode);
+      if (it != nodeIndices.end()) {
+        return it->second;
+      }
+      Int node = cuddIsConstant(ddNode) ? addFlatNode(ddVarCount, -1, -1, cuddV(ddNode)) : addFlatNode(mgr->ReadPerm(ddNode->index), self(self, cuddT(ddNode)), self(self, cuddE(ddNode)), 0);
+      nodeIndices[ddNode] = node;
+      return node;
+    };
+    addNode(addNode, cuadd.getNode());
+  }
+  else {
+    assert(!multiplePrecision);
+    Map<MTBDD, Int> nodeIndices;
+    auto addNode = [&](auto& self, MTBDD node) -> Int {
+      auto it = nodeIndices.find(node);
+      if (it != nodeIndices.end()) {
+        return it->second;
+      }
+      Int flatNode = mtbdd_isleaf(node) ? addFlatNode(ddVarCount, -1, -1, mtbdd_getdouble(node)) : addFlatNode(mtbdd_getvar(node), self(self, mtbdd_gethigh(node)), self(self, mtbdd_getlow(node)), 0);
+      nodeIndices[node] = flatNode;
+      return flatNode;
+    };
+    addNode(addNode, mtbdd.GetMTBDD());
+  }
+  return flatDd;
 }
 
 void Dd::writeDotFile(const Cudd* mgr, string dotFileDir) const {
@@ -617,18 +1524,539 @@ void Dd::writeInfoFile(const Cudd* mgr, string filePath) {
   cout << "c wrote CUDD info to file " << filePath << "\n";
 }
 
+/* class SliceJournal ======================================================= */
+
+string SliceJournal::getAssignmentKey(const Assignment& assignment) {
+  Set<Int> vars;
+  for (const auto& [var, val] : assignment) {
+    vars.insert(var);
+  }
+  string key;
+  for (Int var : util::getSortedNums(vars)) {
+    key += (key.empty() ? "" : " ") + to_string(assignment.getValue(var) ? var : -var);
+  }
+  return key;
+}
+
+string SliceJournal::getRunKey(const JoinNonterminal* joinRoot, const vector<Assignment>& assignments) {
+  const Cnf& cnf = JoinNode::cnf;
+  std::ostringstream textStream;
+  textStream << JoinTreeCache::getStructureKey(cnf) << "\n";
+  textStream << weightedCounting << projectedCounting << existRandom << logCounting << "\n"; // not logBound, which varies with --ls timing, as journaled slice values are valid under any bound
+  for (Int var = 1; var <= cnf.declaredVarCount; var++) {
+    for (Int literal : {var, -var}) {
+      if (cnf.literalWeights.contains(literal)) {
+        textStream << literal << " " << cnf.literalWeights.at(literal) << " ";
+      }
+    }
+    textStream << cnf.outerVars.contains(var) << "\n";
+  }
+
+  string joinTreeBytes;
+  joinRoot->appendSubtreeBytes(joinTreeBytes);
+  textStream << joinTreeBytes << "\n";
+
+  for (const Assignment& assignment : assignments) {
+    textStream << getAssignmentKey(assignment) << " 0\n";
+  }
+  return util::getHashKey(textStream.str());
+}
+
+bool SliceJournal::getFinishedSlice(const Assignment& assignment, Number& partialSolution) const {
+  auto it = finishedSlices.find(getAssignmentKey(assignment));
+  if (it == finishedSlices.end()) {
+    return false;
+  }
+  partialSolution = Number(it->second);
+  return true;
+}
+
+void SliceJournal::addFinishedSlice(const Assignment& assignment, const Number& partialSolution) {
+  string assignmentKey = getAssignmentKey(assignment);
+  finishedSlices[assignmentKey] = partialSolution.fraction;
+  journalStream << assignmentKey << (assignmentKey.empty() ? "" : " ") << "0 " << std::hexfloat << partialSolution.fraction << "\n";
+  journalStream.flush(); // survives if process is killed later
+}
+
+SliceJournal::SliceJournal(string filePath, const JoinNonterminal* joinRoot, const vector<Assignment>& assignments) {
+  this->filePath = filePath;
+  runKey = getRunKey(joinRoot, assignments);
+
+  std::ifstream inputFileStream(filePath);
+  string line;
+  if (std::getline(inputFileStream, line) && line == "c " + JOURNAL_HEADER_WORD + " " + runKey) {
+    while (std::getline(inputFileStream, line)) {
+      vector<string> words = util::splitInputLine(line);
+      if (words.size() < 2 || words.at(words.size() - 2) != "0") {
+        continue; // e.g. last line cut off by killed process
+      }
+      char* end;
+      Float partialSolution = strtold(words.back().c_str(), &end);
+      if (*end != '\0') {
+        continue;
+      }
+      string assignmentKey;
+      for (Int i = 0; i < words.size() - 2; i++) {
+        assignmentKey += (i == 0 ? "" : " ") + words.at(i);
+      }
+      finishedSlices[assignmentKey] = partialSolution;
+    }
+  }
+  inputFileStream.close();
+
+  string tmpFilePath = filePath + "." + to_string(getpid()) + ".tmp";
+  {
+    std::ofstream tmpFileStream(tmpFilePath); // rewrites journal without cut-off lines and entries of other runs
+    tmpFileStream << "c " << JOURNAL_HEADER_WORD << " " << runKey << "\n";
+    for (const auto& [assignmentKey, partialSolution] : finishedSlices) {
+      tmpFileStream << assignmentKey << (assignmentKey.empty() ? "" : " ") << "0 " << std::hexfloat << partialSolution << "\n";
+    }
+  }
+  std::filesystem::rename(tmpFilePath, filePath);
+
+  journalStream.open(filePath, std::ios::app);
+  if (!journalStream) {
+    throw MyError("failed to open checkpoint journal: ", filePath);
+  }
+
+  util::printRow("journalRunKey", runKey);
+  util::printRow("journalFinishedSlices", finishedSlices.size());
+}
+
+/* class SliceWorker ======================================================== */
+
+bool SliceWorker::isIdle() const {
+  return sliceIndex == MIN_INT;
+}
+
+void SliceWorker::sendSlice(Int index, const Assignment& assignment) {
+  sliceIndex = index;
+  sliceStartPoint = util::getTimePoint();
+
+  fprintf(requestFile, "%lld %La %zu", index, Executor::readLogBound(), assignment.size());
+  for (const auto& [var, val] : assignment) {
+    fprintf(requestFile, " %lld", val ? var : -var);
+  }
+  fprintf(requestFile, "\n");
+  fflush(requestFile); // if worker is dead, coordinator finds closed response pipe
+}
+
+void SliceWorker::stop(bool killingFlag) {
+  if (requestFile != nullptr) {
+    fclose(requestFile); // worker exits after reading EOF
+    requestFile = nullptr;
+  }
+  if (responseFile != nullptr) {
+    fclose(responseFile);
+    responseFile = nullptr;
+  }
+  if (pid > 0) {
+    if (killingFlag) {
+      kill(pid, SIGTERM); // stuck worker would never exit
+    }
+    waitpid(pid, nullptr, 0);
+    pid = -1;
+  }
+  sliceIndex = MIN_INT;
+}
+
+void SliceWorker::runWorker(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, Int workerIndex, FILE* requestFile, FILE* responseFile) {
+  try {
+    Int index;
+    Float coordinatorLogBound;
+    size_t literalCount;
+    const Cudd* mgr = Dd::newMgr(maxMem, workerIndex); // each worker process has its own mem cap, unlike threads, which split it
+    while (fscanf(requestFile, "%lld %La %zu", &index, &coordinatorLogBound, &literalCount) == 3) {
+      Executor::raiseLogBound(coordinatorLogBound); // slices finished by other workers
+      Assignment assignment;
+      for (size_t i = 0; i < literalCount; i++) {
+        Int literal;
+        if (fscanf(requestFile, "%lld", &literal) != 1) {
+          _exit(EXIT_FAILURE);
+        }
+        assignment.insert({abs(literal), literal > 0});
+      }
+
+      Float partialSolution = Executor::solveSubtree(static_cast<const JoinNode*>(joinRoot), cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment).extractConst().fraction;
+
+      fprintf(responseFile, "%lld %La\n", index, partialSolution); // hexfloat is exact
+      fflush(responseFile);
+    }
+  }
+  catch (...) {
+    _exit(EXIT_FAILURE); // coordinator retries slice
+  }
+  _exit(EXIT_SUCCESS); // skips destructors and atexit handlers of coordinator
+}
+
+SliceWorker SliceWorker::forkWorker(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, Int workerIndex, const vector<SliceWorker>& workers) {
+  int requestPipe[2];
+  int responsePipe[2];
+  if (pipe(requestPipe) != 0 || pipe(responsePipe) != 0) {
+    throw MyError("failed to create pipes for worker process ", workerIndex + 1);
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    throw MyError("failed to fork worker process ", workerIndex + 1);
+  }
+  if (pid == 0) {
+    for (const SliceWorker& worker : workers) { // otherwise other workers would never read EOF
+      if (worker.requestFile != nullptr) {
+        close(fileno(worker.requestFile));
+      }
+      if (worker.responseFile != nullptr) {
+        close(fileno(worker.responseFile));
+      }
+    }
+    close(requestPipe[1]);
+    close(responsePipe[0]);
+    runWorker(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, workerIndex, fdopen(requestPipe[0], "r"), fdopen(responsePipe[1], "w"));
+  }
+
+  close(requestPipe[0]);
+  close(responsePipe[1]);
+
+  SliceWorker worker;
+  worker.pid = pid;
+  worker.requestFile = fdopen(requestPipe[1], "w");
+  worker.responseFile = fdopen(responsePipe[0], "r");
+  return worker;
+}
+
+/* class DdCounters ========================================================= */
+
+DdCounters DdCounters::getSnapshot(const Cudd* mgr) {
+  DdCounters counters;
+  if (ddPackage == CUDD) {
+    DdManager* manager = mgr->getManager();
+    counters.cacheLookups = Cudd_ReadCacheLookUps(manager);
+    counters.cacheHits = Cudd_ReadCacheHits(manager);
+    counters.garbageCollections = Cudd_ReadGarbageCollections(manager);
+    counters.reorderings = Cudd_ReadReorderings(manager);
+    counters.nodeGrowth = static_cast<Int>(Cudd_ReadKeys(manager)) - Cudd_ReadDead(manager);
+  }
+  else {
+    LACE_ME; // lace worker of calling thread
+    sylvan_stats_t stats;
+    sylvan_stats_snapshot(&stats);
+    for (Int counter = sylvan::BDD_ITE; counter + 2 < sylvan::SYLVAN_GC_COUNT; counter += 3) { // OPCOUNTER triples: calls, cache puts, cache hits
+      counters.cacheLookups += stats.counters[counter];
+      counters.cacheHits += stats.counters[counter + 2];
+    }
+    counters.garbageCollections = stats.counters[sylvan::SYLVAN_GC_COUNT];
+    counters.nodeGrowth = stats.counters[sylvan::BDD_NODES_CREATED];
+  }
+  return counters;
+}
+
+DdCounters DdCounters::operator-(const DdCounters& counters) const {
+  DdCounters difference;
+  difference.cacheLookups = cacheLookups - counters.cacheLookups;
+  difference.cacheHits = cacheHits - counters.cacheHits;
+  difference.garbageCollections = garbageCollections - counters.garbageCollections;
+  difference.reorderings = reorderings - counters.reorderings;
+  difference.nodeGrowth = nodeGrowth - counters.nodeGrowth;
+  return difference;
+}
+
+DdCounters& DdCounters::operator+=(const DdCounters& counters) {
+  cacheLookups += counters.cacheLookups;
+  cacheHits += counters.cacheHits;
+  garbageCollections += counters.garbageCollections;
+  reorderings += counters.reorderings;
+  nodeGrowth += counters.nodeGrowth;
+  return *this;
+}
+
+string DdCounters::getJson() const {
+  return "{\"cacheLookups\": " + to_string(static_cast<Int>(cacheLookups)) + ", \"cacheHits\": " + to_string(static_cast<Int>(cacheHits)) + ", \"garbageCollections\": " + to_string(garbageCollections) + ", \"reorderings\": " + to_string(reorderings) + ", \"nodeGrowth\": " + to_string(nodeGrowth) + "}";
+}
+
+string DdCounters::getCsv() const { // cacheLookups,cacheHits,garbageCollections,reorderings,nodeGrowth
+  return to_string(static_cast<Int>(cacheLookups)) + "," + to_string(static_cast<Int>(cacheHits)) + "," + to_string(garbageCollections) + "," + to_string(reorderings) + "," + to_string(nodeGrowth);
+}
+
+/* class Profiler =========================================================== */
+
+mutex Profiler::bufferMutex;
+vector<std::unique_ptr<vector<ProfileRecord>>> Profiler::buffers;
+thread_local vector<ProfileRecord>* Profiler::threadBuffer = nullptr;
+thread_local Int Profiler::threadSliceIndex = -1;
+
+Int Profiler::getMicroseconds(TimePoint timePoint) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(timePoint - toolStartPoint).count();
+}
+
+DdCounters Profiler::getCounters(const Cudd* mgr) {
+  return profileFilePrefix.empty() ? DdCounters() : DdCounters::getSnapshot(mgr);
+}
+
+void Profiler::addRecord(const JoinNode* joinNode, const Cudd* mgr, TimePoint startPoint, const vector<size_t>& inputSizes, const Dd& dd, const DdCounters& joinCounters, const vector<pair<Int, DdCounters>>& projectionCounters) {
+  if (profileFilePrefix.empty()) {
+    return;
+  }
+  TimePoint endPoint = util::getTimePoint();
+
+  if (threadBuffer == nullptr) {
+    const std::lock_guard<mutex> g(bufferMutex);
+    buffers.push_back(std::make_unique<vector<ProfileRecord>>());
+    threadBuffer = buffers.back().get();
+  }
+
+  ProfileRecord record;
+  record.nodeIndex = joinNode->nodeIndex;
+  record.terminalFlag = joinNode->isTerminal();
+  record.threadIndex = ddPackage == CUDD ? mgr->getManager()->threadIndex : 0;
+  record.sliceIndex = threadSliceIndex;
+  record.startMicroseconds = getMicroseconds(startPoint);
+  record.durationMicroseconds = getMicroseconds(endPoint) - record.startMicroseconds;
+  record.inputSizes = inputSizes;
+  record.outputSize = dd.getNodeCount();
+  record.projectionVars = util::getSortedNums(joinNode->projectionVars);
+  record.joinCounters = joinCounters;
+  record.projectionCounters = projectionCounters;
+  threadBuffer->push_back(record);
+}
+
+vector<ProfileRecord> Profiler::getMergedRecords() {
+  vector<ProfileRecord> records;
+  for (const auto& buffer : buffers) {
+    records.insert(records.end(), buffer->begin(), buffer->end());
+  }
+  std::stable_sort(records.begin(), records.end(), [](const ProfileRecord& record1, const ProfileRecord& record2) {
+    return record1.startMicroseconds < record2.startMicroseconds;
+  });
+  return records;
+}
+
+void Profiler::writeTraceFile(const vector<ProfileRecord>& records, string filePath) {
+  std::ofstream outputFileStream(filePath);
+  outputFileStream << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+
+  Set<Int> threadIndices;
+  for (const ProfileRecord& record : records) {
+    threadIndices.insert(record.threadIndex);
+  }
+  for (Int threadIndex : util::getSortedNums(threadIndices)) { // names tracks
+    outputFileStream << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << threadIndex << ", \"args\": {\"name\": \"thread " << threadIndex + 1 << "\"}},\n";
+  }
+
+  for (Int i = 0; i < records.size(); i++) {
+    const ProfileRecord& record = records.at(i);
+    outputFileStream << "{\"name\": \"node " << record.nodeIndex + 1 << "\"";
+    outputFileStream << ", \"cat\": \"" << (record.terminalFlag ? "terminal" : "nonterminal") << "\"";
+    outputFileStream << ", \"ph\": \"X\", \"pid\": 0, \"tid\": " << record.threadIndex;
+    outputFileStream << ", \"ts\": " << record.startMicroseconds << ", \"dur\": " << record.durationMicroseconds;
+    outputFileStream << ", \"args\": {\"slice\": " << record.sliceIndex << ", \"inputSizes\": [";
+    for (Int j = 0; j < record.inputSizes.size(); j++) {
+      outputFileStream << (j > 0 ? ", " : "") << record.inputSizes.at(j);
+    }
+    outputFileStream << "], \"outputSize\": " << record.outputSize << ", \"projectionVars\": [";
+    for (Int j = 0; j < record.projectionVars.size(); j++) {
+      outputFileStream << (j > 0 ? ", " : "") << record.projectionVars.at(j);
+    }
+    outputFileStream << "], \"joinCounters\": " << record.joinCounters.getJson() << ", \"projectionCounters\": [";
+    for (Int j = 0; j < record.projectionCounters.size(); j++) {
+      const auto& [var, counters] = record.projectionCounters.at(j);
+      outputFileStream << (j > 0 ? ", " : "") << "{\"var\": " << var << ", \"counters\": " << counters.getJson() << "}";
+    }
+    outputFileStream << "]}}" << (i + 1 < records.size() ? "," : "") << "\n";
+  }
+
+  outputFileStream << "]}\n";
+}
+
+void Profiler::writeCsvFile(const vector<ProfileRecord>& records, string filePath) {
+  std::ofstream outputFileStream(filePath);
+  outputFileStream << "node,terminal,thread,slice,startMicroseconds,durationMicroseconds,inputSizes,outputSize,projectionVars";
+  for (string phase : {"join", "projection"}) {
+    for (string counter : {"CacheLookups", "CacheHits", "GarbageCollections", "Reorderings", "NodeGrowth"}) {
+      outputFileStream << "," << phase << counter;
+    }
+  }
+  outputFileStream << "\n";
+  for (const ProfileRecord& record : records) {
+    outputFileStream << record.nodeIndex + 1 << "," << record.terminalFlag << "," << record.threadIndex + 1 << "," << record.sliceIndex << ",";
+    outputFileStream << record.startMicroseconds << "," << record.durationMicroseconds << ",";
+    for (Int j = 0; j < record.inputSizes.size(); j++) { // space-separated lists keep one field per column
+      outputFileStream << (j > 0 ? " " : "") << record.inputSizes.at(j);
+    }
+    outputFileStream << "," << record.outputSize << ",";
+    for (Int j = 0; j < record.projectionVars.size(); j++) {
+      outputFileStream << (j > 0 ? " " : "") << record.projectionVars.at(j);
+    }
+    DdCounters projectionCounters; // summed over vars
+    for (const auto& [var, counters] : record.projectionCounters) {
+      projectionCounters += counters;
+    }
+    outputFileStream << "," << record.joinCounters.getCsv() << "," << projectionCounters.getCsv() << "\n";
+  }
+}
+
+void Profiler::writeVarCsvFile(const vector<ProfileRecord>& records, string filePath) {
+  Map<Int, DdCounters> varCounters;
+  Map<Int, Int> varProjectionCounts; // > 1 if var is projected in several slices
+  for (const ProfileRecord& record : records) {
+    for (const auto& [var, counters] : record.projectionCounters) {
+      varCounters[var] += counters;
+      varProjectionCounts[var]++;
+    }
+  }
+
+  std::ofstream outputFileStream(filePath);
+  outputFileStream << "var,projections,cacheLookups,cacheHits,garbageCollections,reorderings,nodeGrowth\n";
+  Set<Int> vars;
+  for (const auto& [var, counters] : varCounters) {
+    vars.insert(var);
+  }
+  for (Int var : util::getSortedNums(vars)) {
+    outputFileStream << var << "," << varProjectionCounts.at(var) << "," << varCounters.at(var).getCsv() << "\n";
+  }
+}
+
+void Profiler::writeFiles() {
+  if (profileFilePrefix.empty()) {
+    return;
+  }
+  vector<ProfileRecord> records = getMergedRecords();
+  writeTraceFile(records, profileFilePrefix + ".json");
+  writeCsvFile(records, profileFilePrefix + ".csv");
+  writeVarCsvFile(records, profileFilePrefix + ".vars.csv");
+  util::printRow("profileRecordCount", records.size());
+}
+
+/* class MemoryGovernor ===================================================== */
+
+mutex MemoryGovernor::governorMutex;
+vector<std::unique_ptr<MemoryGovernor>> MemoryGovernor::governors;
+std::atomic<size_t> MemoryGovernor::liveNodeCount;
+std::atomic<size_t> MemoryGovernor::tableSize = 1;
+std::atomic<Int> MemoryGovernor::collectionCount;
+std::atomic<Int> MemoryGovernor::growthCapCount;
+std::atomic<Int> MemoryGovernor::exhaustionCount;
+std::atomic<Int> MemoryGovernor::reslicedSubtreeCount;
+
+void MemoryGovernor::govern(const Cudd* mgr, Float mem) {
+  std::unique_ptr<MemoryGovernor> governor(new MemoryGovernor());
+  governor->manager = mgr->getManager();
+  governor->memLimit = memoryGovernor * mem * MEGA;
+  mgr->SetMaxCacheHard(getMaxCacheSlots(mem)); // cache table stays within quarter of memLimit
+  mgr->RegisterTerminationCallback(checkMem, governor.get());
+  mgr->setTerminationHandler(throwExhaustion); // instead of defaultError, which aborts via uncaught logic_error
+
+  const std::lock_guard<mutex> g(governorMutex);
+  governors.push_back(std::move(governor));
+}
+
+void MemoryGovernor::ungovern(const Cudd* mgr) {
+  const std::lock_guard<mutex> g(governorMutex);
+  std::erase_if(governors, [&](const std::unique_ptr<MemoryGovernor>& governor) { return governor->manager == mgr->getManager(); });
+}
+
+size_t MemoryGovernor::getMaxCacheSlots(Float mem) {
+  return std::max(size_t(1), size_t(memoryGovernor * mem * MEGA / 4 / sizeof(DdCache))); // CUDD rounds down to power of 2
+}
+
+size_t MemoryGovernor::getLiveMem() const {
+  return (manager->keys - manager->dead) * sizeof(DdNode) + manager->cacheSlots * sizeof(DdCache);
+}
+
+int MemoryGovernor::checkMem(const void* governor) {
+  MemoryGovernor* g = static_cast<MemoryGovernor*>(const_cast<void*>(governor));
+  DdManager* manager = g->manager;
+
+  if (manager->nextFree != NULL) { // polled by cuddUniqueInter, whose callers handle NULL
+    if (g->exhaustedFlag) {
+      g->exhaustedFlag = false;
+      exhaustionCount++;
+      return 1; // CUDD_TERMINATION unwinds current operation, then throwExhaustion runs in checkReturnValue
+    }
+    return 0;
+  }
+
+  // free list is empty, so cuddAllocNode is about to allocate a new chunk, which must not fail: terminal cases like Cudd_addTimes read NULL from cuddUniqueConst as non-terminal
+  if (g->getLiveMem() <= g->memLimit) {
+    return 0;
+  }
+  if (manager->dead >= DD_MEM_CHUNK) { // collecting garbage frees at least one chunk of nodes
+    if (manager->memused <= manager->maxmem) { // else cuddAllocNode collects garbage itself
+      cuddGarbageCollect(manager, 1); // also clears dead cache entries
+    }
+    collectionCount++;
+    return 0;
+  }
+  if (!g->growthCapped) {
+    cuddSlowTableGrowth(manager); // caps cache at current size and defers resizing unique subtables
+    g->growthCapped = true;
+    growthCapCount++;
+  }
+  g->exhaustedFlag = true; // terminates at next poll
+  return 0;
+}
+
+void MemoryGovernor::throwExhaustion(string) { // CUDD's message is dropped, as exhaustion is reported by reslicedSubtreeCount or MyError
+  throw MemoryExhaustionException();
+}
+
+void MemoryGovernor::updateTableFill(WorkerP* worker, Task* task) {
+  size_t filled, total;
+  sylvan_table_usage_CALL(worker, task, &filled, &total);
+  liveNodeCount = filled;
+  tableSize = total;
+}
+
+void MemoryGovernor::checkTableFill() {
+  if (ddPackage != SYLVAN || liveNodeCount <= memoryGovernor * tableSize) {
+    return;
+  }
+  LACE_ME;
+  sylvan_gc_CALL(__lace_worker, __lace_dq_head); // grows node table if below max size, then updateTableFill runs
+  collectionCount++;
+  if (liveNodeCount > memoryGovernor * tableSize) {
+    exhaustionCount++;
+    throw MemoryExhaustionException();
+  }
+}
+
 /* class Executor =========================================================== */
 
 vector<pair<Int, Dd>> Executor::maximizationStack;
 Int Executor::prunedDdCount;
+mutex Executor::logBoundMutex;
+
+Int Executor::skippedSliceCount;
+
+Float Executor::logErrorBound;
+
+thread_local const Map<Int, Number>* Executor::threadLiteralWeights = nullptr;
+std::atomic<Int> Executor::roundedDdCount;
+
+thread_local bool Executor::governedSolvingFlag = false;
+thread_local Set<string> Executor::splitSubtreeKeys;
+
+Map<const Cudd*, Map<string, Dd>> Executor::clauseDdCaches;
+mutex Executor::clauseDdCacheMutex;
+std::atomic<Int> Executor::clauseDdCount;
+std::atomic<Int> Executor::clauseDdCacheHitCount;
+
+mutex Executor::reorderingMutex;
+Int Executor::reorderingCount;
+Float Executor::reorderingDuration;
+Int Executor::preReorderingNodeCount;
+Int Executor::postReorderingNodeCount;
+std::atomic<size_t> Executor::peakDdSize;
+SliceJournal* Executor::sliceJournal = nullptr;
 
 Map<Int, Float> Executor::varDurations;
 Map<Int, size_t> Executor::varDdSizes;
+mutex Executor::varStatsMutex;
 
 void Executor::updateVarDurations(const JoinNode* joinNode, TimePoint startPoint) {
   if (verboseProfiling >= 1) {
     Float duration = util::getDuration(startPoint);
     if (duration > 0) {
+      const std::lock_guard<mutex> g(varStatsMutex);
       if (verboseProfiling >= 2) {
         util::printRow("joinNodeSeconds_" + to_string(joinNode->nodeIndex + 1), duration);
       }
@@ -649,6 +2077,7 @@ void Executor::updateVarDdSizes(const JoinNode* joinNode, const Dd& dd) {
   if (verboseProfiling >= 1) {
     size_t ddSize = dd.getNodeCount();
 
+    const std::lock_guard<mutex> g(varStatsMutex);
     if (verboseProfiling >= 2) {
       util::printRow("joinNodeDiagramSize_" + to_string(joinNode->nodeIndex + 1), ddSize);
     }
@@ -664,6 +2093,14 @@ void Executor::updateVarDdSizes(const JoinNode* joinNode, const Dd& dd) {
   }
 }
 
+void Executor::updatePeakDdSize(const Dd& dd) {
+  if (joinTreeOptimization) {
+    size_t ddSize = dd.getNodeCount();
+    size_t prevPeakDdSize = peakDdSize;
+    while (ddSize > prevPeakDdSize && !peakDdSize.compare_exchange_weak(prevPeakDdSize, ddSize)) {}
+  }
+}
+
 void Executor::printVarDurations() {
   multimap<Float, Int, greater<Float>> timedVars = util::flipMap(varDurations); // duration |-> var
   for (pair<Float, Int> timedVar : timedVars) {
@@ -678,8 +2115,60 @@ void Executor::printVarDdSizes() {
   }
 }
 
+void Executor::reorderDdVars(const Cudd* mgr) {
+  if (!dynamicReordering || mgr == nullptr) {
+    return;
+  }
+  Int preNodeCount = mgr->ReadNodeCount();
+  if (preNodeCount < mgr->ReadNextReordering()) {
+    return;
+  }
+
+  TimePoint reorderingStartPoint = util::getTimePoint();
+  mgr->ReduceHeap(dynamicReordering == SIFT_REORDERING ? CUDD_REORDER_SIFT : CUDD_REORDER_WINDOW3); // DD var indices (hence var maps and maximization stack) are unchanged
+  mgr->SetNextReordering(max(static_cast<Int>(mgr->ReadNextReordering()), reorderingThreshold)); // ReduceHeap sets next reordering relative to new size
+  Int postNodeCount = mgr->ReadNodeCount();
+
+  const std::lock_guard<mutex> g(reorderingMutex);
+  reorderingCount++;
+  reorderingDuration += util::getDuration(reorderingStartPoint);
+  preReorderingNodeCount += preNodeCount;
+  postReorderingNodeCount += postNodeCount;
+  if (verboseSolving >= 2) {
+    cout << "c reordering " << reorderingCount << ": " << preNodeCount << " -> " << postNodeCount << " nodes\n";
+  }
+}
+
+void Executor::releaseMem(const Cudd* mgr) {
+  {
+    const std::lock_guard<mutex> g(clauseDdCacheMutex);
+    clauseDdCaches[mgr].clear(); // pinned clause DDs are rebuilt on demand
+  }
+  if (ddPackage == CUDD) {
+    mgr->ClearErrorCode();
+    cuddGarbageCollect(mgr->getManager(), 1);
+  }
+  else {
+    LACE_ME;
+    sylvan_gc_CALL(__lace_worker, __lace_dq_head);
+  }
+}
+
+void Executor::deleteMgr(const Cudd* mgr) {
+  assert(ddPackage == CUDD);
+  {
+    const std::lock_guard<mutex> g(clauseDdCacheMutex);
+    clauseDdCaches.erase(mgr); // dereferences cached ADDs before manager is gone
+  }
+  if (memoryGovernor > 0) {
+    MemoryGovernor::ungovern(mgr);
+  }
+  delete mgr;
+}
+
 Dd Executor::getClauseDd(const Map<Int, Int>& cnfVarToDdVarMap, const Clause& clause, const Cudd* mgr, const Assignment& assignment) {
-  Dd clauseDd = Dd::getZeroDd(mgr);
+  bool parityFlag = false; // odd number of true literals removed from XOR clause
+  vector<Int> literals; // unassigned
   for (Int literal : clause) {
     bool val = literal > 0;
     Int cnfVar = abs(literal);
@@ -687,40 +2176,150 @@ Dd Executor::getClauseDd(const Map<Int, Int>& cnfVarToDdVarMap, const Clause& cl
     if (it != assignment.end()) { // literal has assigned value
       if (it->second == val) {
         if (clause.xorFlag) { // flips polarity
-          clauseDd = clauseDd.getXor(Dd::getOneDd(mgr));
+          parityFlag = !parityFlag;
         }
         else { // returns satisfied disjunctive clause
           return Dd::getOneDd(mgr);
         }
       } // excludes unsatisfied literal from clause otherwise
     }
-    else { // literal is unassigned
-      Int ddVar = cnfVarToDdVarMap.at(cnfVar);
-      Dd literalDd = Dd::getVarDd(ddVar, val, mgr);
-      clauseDd = clause.xorFlag ? clauseDd.getXor(literalDd) : clauseDd.getMax(literalDd);
+    else if (clause.contains(-literal)) { // exactly one of complementary literals is true
+      if (!clause.xorFlag) {
+        return Dd::getOneDd(mgr);
+      }
+      if (val) { // flips polarity once per pair
+        parityFlag = !parityFlag;
+      }
+    }
+    else {
+      literals.push_back(literal);
     }
   }
+  sort(literals.begin(), literals.end());
+
+  string key = clause.xorFlag ? (parityFlag ? "x1" : "x0") : "o";
+  for (Int literal : literals) {
+    key += " " + to_string(literal);
+  }
+
+  Map<string, Dd>* cache;
+  {
+    const std::lock_guard<mutex> g(clauseDdCacheMutex);
+    cache = &clauseDdCaches[mgr]; // references to elements of unordered map stay valid
+  }
+  auto it = cache->find(key);
+  if (it != cache->end()) { // same restricted clause in earlier slice or another join-tree leaf
+    clauseDdCacheHitCount++;
+    return it->second;
+  }
+
+  vector<pair<Int, pair<Int, bool>>> leveledDdLiterals; // (level, (DD var, val))
+  for (Int literal : literals) {
+    Int ddVar = cnfVarToDdVarMap.at(abs(literal));
+    leveledDdLiterals.push_back({Dd::getVarLevel(ddVar, mgr), {ddVar, literal > 0}});
+  }
+  sort(leveledDdLiterals.begin(), leveledDdLiterals.end(), greater<pair<Int, pair<Int, bool>>>()); // bottom level first
+  vector<pair<Int, bool>> ddLiterals;
+  for (const auto& leveledDdLiteral : leveledDdLiterals) {
+    ddLiterals.push_back(leveledDdLiteral.second);
+  }
+
+  Dd clauseDd = Dd::getClauseDd(ddLiterals, clause.xorFlag, parityFlag, mgr);
+  clauseDdCount++;
+  cache->insert({key, clauseDd});
   return clauseDd;
 }
 
+Dd Executor::getProjectedDd(const Dd& dd, Int cnfVar, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr, const Assignment& assignment) {
+  Int ddVar = cnfVarToDdVarMap.at(cnfVar);
+
+  bool additiveFlag = JoinNode::cnf.outerVars.contains(cnfVar);
+  if (existRandom) {
+    additiveFlag = !additiveFlag;
+  }
+
+  Dd projectedDd = dd.getAbstraction(ddVar, ddVarToCnfVarMap, getLiteralWeights(), assignment, additiveFlag, maximizationStack, mgr);
+
+  Float currentLogBound = readLogBound(); // may have been raised by other threads
+  if (currentLogBound > -INF) {
+    if (JoinNode::cnf.literalWeights.at(cnfVar) < Number(1) || JoinNode::cnf.literalWeights.at(-cnfVar) < Number(1)) {
+      Dd prunedDd = projectedDd.getPrunedDd(currentLogBound, mgr);
+      if (prunedDd != projectedDd) {
+        if (verboseSolving >= 3) {
+          cout << "c writing pre-pruning decision diagram...\n";
+          projectedDd.writeDotFile(mgr);
+
+          cout << "c writing post-pruning decision diagram...\n";
+          prunedDd.writeDotFile(mgr);
+        }
+        prunedDdCount++;
+        projectedDd = prunedDd;
+      }
+    }
+  }
+
+  return projectedDd;
+}
+
 Dd Executor::solveSubtree(const JoinNode* joinNode, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr, const Assignment& assignment) {
   if (joinNode->isTerminal()) {
     TimePoint terminalStartPoint = util::getTimePoint();
+    DdCounters terminalStartCounters = Profiler::getCounters(mgr);
 
     Dd d = getClauseDd(cnfVarToDdVarMap, JoinNode::cnf.clauses.at(joinNode->nodeIndex), mgr, assignment);
 
     updateVarDurations(joinNode, terminalStartPoint);
     updateVarDdSizes(joinNode, d);
+    updatePeakDdSize(d);
+    Profiler::addRecord(joinNode, mgr, terminalStartPoint, vector<size_t>(), d, Profiler::getCounters(mgr) - terminalStartCounters, vector<pair<Int, DdCounters>>());
 
     return d;
   }
 
+  const JoinNonterminal* joinNonterminal = static_cast<const JoinNonterminal*>(joinNode);
+  if (memoryGovernor <= 0) {
+    return solveNonterminal(joinNonterminal, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment);
+  }
+  if (!governedSolvingFlag) { // outermost call: exhaustion that re-slicing cannot avoid ends here
+    governedSolvingFlag = true;
+    splitSubtreeKeys.clear();
+    try {
+      Dd dd = solveSubtree(joinNode, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment);
+      governedSolvingFlag = false;
+      return dd;
+    }
+    catch (const MemoryExhaustionException&) {
+      governedSolvingFlag = false;
+      throw MyError("memory governor cannot fit join node ", joinNode->nodeIndex + 1, " in ", memoryGovernor, " of mem share even after re-slicing on all outer vars; raise --mm or --mg");
+    }
+    catch (...) {
+      governedSolvingFlag = false;
+      throw;
+    }
+  }
+  try {
+    return solveNonterminal(joinNonterminal, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment);
+  }
+  catch (const ReslicingExhaustionException&) { // re-slicing this node would repeat exhausted slices of descendant
+    throw;
+  }
+  catch (const MemoryExhaustionException&) { // child DDs of this node are released during unwinding
+    releaseMem(mgr);
+  }
+  return solveReslicedSubtree(joinNonterminal, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment); // may throw to ancestor
+}
+
+Dd Executor::solveNonterminal(const JoinNonterminal* joinNode, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr, const Assignment& assignment) {
   vector<Dd> childDdList;
   for (JoinNode* child : joinNode->children) {
     childDdList.push_back(solveSubtree(child, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment));
   }
+  if (memoryGovernor > 0) {
+    MemoryGovernor::checkTableFill();
+  }
 
   TimePoint nonterminalStartPoint = util::getTimePoint();
+  DdCounters joinStartCounters = Profiler::getCounters(mgr);
   Dd dd = Dd::getOneDd(mgr);
 
   if (joinPriority == ARBITRARY_PAIR) { // arbitrarily multiplies child decision diagrams
@@ -744,50 +2343,634 @@ Dd Executor::solveSubtree(const JoinNode* joinNode, const Map<Int, Int>& cnfVarT
     }
     dd = childDdQueue.top();
   }
+  updatePeakDdSize(dd);
+  reorderDdVars(mgr);
+  DdCounters joinCounters = Profiler::getCounters(mgr) - joinStartCounters;
 
+  vector<pair<Int, DdCounters>> projectionCounters;
   for (Int cnfVar : joinNode->projectionVars) {
-    Int ddVar = cnfVarToDdVarMap.at(cnfVar);
+    DdCounters projectionStartCounters = Profiler::getCounters(mgr);
+    dd = getProjectedDd(dd, cnfVar, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment);
+    if (!profileFilePrefix.empty()) {
+      projectionCounters.push_back({cnfVar, Profiler::getCounters(mgr) - projectionStartCounters});
+    }
+  }
+  if (approximationTolerance > 0) {
+    Dd roundedDd = dd.getRoundedDd(log10l(1 + approximationTolerance), mgr);
+    if (roundedDd.getNodeCount() < dd.getNodeCount()) { // keeps exact DD if no terminals merge
+      roundedDdCount++;
+      dd = roundedDd;
+    }
+  }
 
-    bool additiveFlag = JoinNode::cnf.outerVars.contains(cnfVar);
-    if (existRandom) {
-      additiveFlag = !additiveFlag;
+  updateVarDurations(joinNode, nonterminalStartPoint);
+  updateVarDdSizes(joinNode, dd);
+  if (!profileFilePrefix.empty()) {
+    vector<size_t> inputSizes;
+    for (const Dd& childDd : childDdList) {
+      inputSizes.push_back(childDd.getNodeCount());
+    }
+    Profiler::addRecord(joinNode, mgr, nonterminalStartPoint, inputSizes, dd, joinCounters, projectionCounters);
+  }
+
+  return dd;
+}
+
+Dd Executor::solveReslicedSubtree(const JoinNonterminal* joinNode, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr, const Assignment& assignment) {
+  Map<Int, size_t> varSizes; // vars in subtree only
+  joinNode->updateVarSizes(varSizes);
+  Int sliceVar = MIN_INT;
+  for (Int var : joinNode->getBiggestNodeVarOrder()) {
+    if (varSizes.contains(var) && JoinNode::cnf.outerVars.contains(var) && !assignment.contains(var)) { // like JoinNonterminal::getOuterAssignments
+      sliceVar = var;
+      break;
+    }
+  }
+  if (sliceVar == MIN_INT) { // bounds re-slicing depth by num of unassigned outer vars in subtree
+    throw MemoryExhaustionException();
+  }
+  Assignment subtreeAssignment; // other vars do not affect subtree
+  for (const auto& [var, val] : assignment) {
+    if (varSizes.contains(var)) {
+      subtreeAssignment.insert({var, val});
+    }
+  }
+  if (!splitSubtreeKeys.insert(to_string(joinNode->nodeIndex) + ":" + SliceJournal::getAssignmentKey(subtreeAssignment)).second) { // splitting again would repeat exhausted slices
+    throw MemoryExhaustionException();
+  }
+  MemoryGovernor::reslicedSubtreeCount++;
+  if (verboseSolving >= 2) {
+    cout << "c re-slicing join node " << joinNode->nodeIndex + 1 << " on var " << sliceVar << "\n";
+  }
+
+  try {
+    vector<Dd> sliceDds;
+    for (bool val : {false, true}) {
+      Assignment sliceAssignment = assignment;
+      sliceAssignment.insert({sliceVar, val});
+      sliceDds.push_back(solveSubtree(joinNode, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, sliceAssignment)); // slice may be re-sliced further
+    }
+
+    if (joinNode->getPostProjectionVars().contains(sliceVar)) { // ancestor projects sliceVar, so both cofactors are kept
+      Int ddVar = cnfVarToDdVarMap.at(sliceVar);
+      Dd lowDd = Dd::getVarDd(ddVar, false, mgr).getProduct(sliceDds.at(0));
+      return Dd::getVarDd(ddVar, true, mgr).getProduct(sliceDds.at(1)).getSum(lowDd);
+    }
+    bool additiveFlag = !existRandom; // sliceVar is outer and was projected in subtree with its literal weight
+    return additiveFlag ? sliceDds.at(0).getSum(sliceDds.at(1)) : sliceDds.at(0).getMax(sliceDds.at(1));
+  }
+  catch (const MemoryExhaustionException&) { // else each ancestor would re-solve this subtree on every slice, exponentially
+    throw ReslicingExhaustionException();
+  }
+}
+
+Float Executor::readLogBound() {
+  const std::lock_guard<mutex> g(logBoundMutex);
+  return logBound;
+}
+
+void Executor::raiseLogBound(Float newLogBound) {
+  const std::lock_guard<mutex> g(logBoundMutex);
+  if (newLogBound > logBound) {
+    logBound = newLogBound;
+    if (verboseSolving >= 2) {
+      util::printRow("raisedLogBound", logBound);
+    }
+  }
+}
+
+const Map<Int, Number>& Executor::getLiteralWeights() {
+  return threadLiteralWeights != nullptr ? *threadLiteralWeights : JoinNode::cnf.literalWeights;
+}
+
+Dd Executor::getWeightlessDd(const JoinNode* joinNode, const Map<Int, Int>& cnfVarToDdVarMap, const Cudd* mgr, size_t memLimit) {
+  if (joinNode->isTerminal()) {
+    return getClauseDd(cnfVarToDdVarMap, JoinNode::cnf.clauses.at(joinNode->nodeIndex), mgr, Assignment());
+  }
+  Dd dd = Dd::getOneDd(mgr);
+  for (const JoinNode* child : joinNode->children) {
+    dd = dd.getProduct(getWeightlessDd(child, cnfVarToDdVarMap, mgr, memLimit));
+    if (ddPackage == CUDD && Cudd_ReadMemoryInUse(mgr->getManager()) > memLimit) {
+      throw MemoryExhaustionException();
+    }
+  }
+  return dd;
+}
+
+vector<Int> Executor::getWeightlessProjectionOrder(const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr) {
+  vector<pair<Int, Int>> levels; // (level, DD var)
+  for (Int ddVar = 0; ddVar < ddVarToCnfVarMap.size(); ddVar++) {
+    levels.push_back({Dd::getVarLevel(ddVar, mgr), ddVar});
+  }
+  sort(levels.begin(), levels.end(), greater<pair<Int, Int>>()); // bottom level first, so that projected DD is no bigger than levels above
+  vector<Int> cnfVars;
+  for (auto [level, ddVar] : levels) {
+    cnfVars.push_back(ddVarToCnfVarMap.at(ddVar));
+  }
+  std::stable_partition(cnfVars.begin(), cnfVars.end(), [](Int cnfVar) { return !JoinNode::cnf.outerVars.contains(cnfVar); }); // inner vars are projected before outer vars, as in valid join trees
+  return cnfVars;
+}
+
+void Executor::writeCompiledCnf(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap) {
+  TimePoint compilationStartPoint = util::getTimePoint();
+  const Cudd* mgr = ddPackage == CUDD ? Dd::newMgr(maxMem) : nullptr;
+  try {
+    Dd dd = getWeightlessDd(joinRoot, cnfVarToDdVarMap, mgr, maxMem * MEGA);
+    if (ddPackage == CUDD) { // inner vars sink below outer vars, so that dmq projects in one pass
+      vector<int> permutation(ddVarToCnfVarMap.size()); // level |-> DD var
+      for (Int ddVar = 0; ddVar < ddVarToCnfVarMap.size(); ddVar++) {
+        permutation.at(Dd::getVarLevel(ddVar, mgr)) = ddVar;
+      }
+      auto innerVarIt = std::stable_partition(permutation.begin(), permutation.end(), [&](int ddVar) { return JoinNode::cnf.outerVars.contains(ddVarToCnfVarMap.at(ddVar)); });
+      if (std::any_of(innerVarIt, permutation.end(), [&](int ddVar) { return Dd::getVarLevel(ddVar, mgr) < innerVarIt - permutation.begin(); })) {
+        mgr->ShuffleHeap(permutation.data());
+      }
+    }
+    WeightlessDd flatDd = dd.getFlattenedDd(ddVarToCnfVarMap.size(), mgr);
+    if (logCounting) { // file has linear terminal values
+      for (Float& value : flatDd.terminalValues) {
+        value = exp10l(value);
+      }
+    }
+    CompiledCnf(flatDd, ddVarToCnfVarMap, existRandom, JoinNode::cnf).writeFile(compiledCnfPath);
+    util::printRow("compiledDiagramSize", flatDd.nodeLevels.size());
+  }
+  catch (const MemoryExhaustionException&) {
+    cout << WARNING << "weightless diagram exceeded max mem; wrote no compiled CNF file\n";
+  }
+  if (mgr != nullptr) {
+    releaseMem(mgr);
+  }
+  util::printRow("compiledCnfSeconds", util::getDuration(compilationStartPoint));
+}
+
+Dd Executor::solveInsideDds(const JoinNode* joinNode, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr, Map<const JoinNode*, Dd>& joinedDds, Map<const JoinNode*, Dd>& outputDds) {
+  if (joinNode->isTerminal()) {
+    Dd dd = getClauseDd(cnfVarToDdVarMap, JoinNode::cnf.clauses.at(joinNode->nodeIndex), mgr, Assignment());
+    outputDds.emplace(joinNode, dd);
+    return dd;
+  }
+  Dd dd = Dd::getOneDd(mgr);
+  for (const JoinNode* child : joinNode->children) {
+    dd = dd.getProduct(solveInsideDds(child, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, joinedDds, outputDds));
+  }
+  joinedDds.emplace(joinNode, dd);
+  for (Int cnfVar : joinNode->projectionVars) {
+    dd = getProjectedDd(dd, cnfVar, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, Assignment());
+  }
+  outputDds.emplace(joinNode, dd);
+  return dd;
+}
+
+void Executor::addOutsideDds(const JoinNonterminal* joinNode, const Dd& outsideDd, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr, const Map<const JoinNode*, Dd>& joinedDds, const Map<const JoinNode*, Dd>& outputDds, vector<pair<const JoinNonterminal*, WeightlessDd>>& flatDds) {
+  flatDds.push_back({joinNode, joinedDds.at(joinNode).getProduct(outsideDd).getFlattenedDd(ddVarToCnfVarMap.size(), mgr)});
+
+  for (const JoinNode* child : joinNode->children) {
+    if (child->isTerminal()) {
+      continue;
+    }
+    vector<pair<Dd, Set<Int>>> factors = {{outsideDd, joinNode->getPostProjectionVars()}}; // (DD, vars)
+    for (const JoinNode* sibling : joinNode->children) {
+      if (sibling != child) {
+        factors.push_back({outputDds.at(sibling), sibling->getPostProjectionVars()});
+      }
+    }
+    Set<Int> childVars = child->getPostProjectionVars();
+    for (Int i = 0; i < factors.size(); i++) { // projects vars that no other factor has, like solveNonterminal
+      for (Int cnfVar : util::getSortedNums(factors.at(i).second)) {
+        bool sharedFlag = childVars.contains(cnfVar);
+        for (Int j = 0; j < factors.size() && !sharedFlag; j++) {
+          sharedFlag = j != i && factors.at(j).second.contains(cnfVar);
+        }
+        if (!sharedFlag) {
+          factors.at(i).first = getProjectedDd(factors.at(i).first, cnfVar, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, Assignment());
+          factors.at(i).second.erase(cnfVar);
+        }
+      }
+    }
+    std::sort(factors.begin(), factors.end(), [](const pair<Dd, Set<Int>>& a, const pair<Dd, Set<Int>>& b) { return a.first.getNodeCount() < b.first.getNodeCount(); });
+
+    Dd product = factors.front().first; // remaining vars outside child are shared by factors
+    vector<Int> ddVars;
+    for (const pair<Dd, Set<Int>>& factor : factors) {
+      for (Int cnfVar : factor.second) {
+        if (!childVars.contains(cnfVar) && !util::isFound(cnfVarToDdVarMap.at(cnfVar), ddVars)) {
+          Int ddVar = cnfVarToDdVarMap.at(cnfVar);
+          ddVars.push_back(ddVar);
+          product = product.getProduct(Dd::getNodeDd(ddVar, Dd::getConstDd(getLiteralWeights().at(cnfVar), mgr), Dd::getConstDd(getLiteralWeights().at(-cnfVar), mgr), mgr)); // weights go into smallest factor
+        }
+      }
+    }
+    for (Int i = 1; i < factors.size(); i++) {
+      product = product.getProduct(factors.at(i).first);
+    }
+    addOutsideDds(static_cast<const JoinNonterminal*>(child), product.getSumAbstraction(ddVars, mgr), cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, joinedDds, outputDds, flatDds);
+  }
+}
+
+Number Executor::solveMarginals(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap) {
+  const Cudd* mgr = ddPackage == CUDD ? Dd::newMgr(maxMem) : nullptr;
+  const Cnf& cnf = JoinNode::cnf;
+
+  TimePoint insideStartPoint = util::getTimePoint();
+  Map<const JoinNode*, Dd> joinedDds;
+  Map<const JoinNode*, Dd> outputDds;
+  Number apparentSolution = solveInsideDds(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, joinedDds, outputDds).extractConst();
+  util::printRow("insideSeconds", util::getDuration(insideStartPoint));
+
+  TimePoint outsideStartPoint = util::getTimePoint();
+  vector<pair<const JoinNonterminal*, WeightlessDd>> flatDds; // one per nonterminal
+  addOutsideDds(joinRoot, Dd::getOneDd(mgr), cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, joinedDds, outputDds, flatDds);
+  joinedDds.clear();
+  outputDds.clear();
+  util::printRow("outsideSeconds", util::getDuration(outsideStartPoint));
+
+  TimePoint marginalStartPoint = util::getTimePoint();
+  vector<bool> additiveFlags(ddVarToCnfVarMap.size(), true);
+  Int taskVarCount = max(weightLaneCount / 2, Int(1)); // lanes for var true and var false
+  vector<std::tuple<Int, Int, Int>> tasks; // (flat DD index, first projection var index, end index), each for one pass
+  vector<vector<Int>> projectionVars; // by flat DD index
+  for (Int i = 0; i < flatDds.size(); i++) {
+    projectionVars.push_back(util::getSortedNums(flatDds.at(i).first->projectionVars));
+    for (Int j = 0; j < projectionVars.back().size(); j += taskVarCount) {
+      tasks.push_back({i, j, min(j + taskVarCount, static_cast<Int>(projectionVars.back().size()))});
+    }
+  }
+  Map<Int, pair<Number, Number>> marginals; // var |-> (count with var true, count with var false)
+  mutex marginalsMutex;
+  std::atomic<Int> nextTask(0);
+  auto solveTasks = [&]() {
+    for (Int taskIndex = nextTask++; taskIndex < tasks.size(); taskIndex = nextTask++) {
+      auto [flatIndex, firstIndex, endIndex] = tasks.at(taskIndex);
+      const JoinNonterminal* joinNode = flatDds.at(flatIndex).first;
+      Map<Int, Number> scopeWeights = cnf.literalWeights; // vars outside joinNode contribute factor 1
+      for (Int cnfVar : ddVarToCnfVarMap) {
+        if (!joinNode->preProjectionVars.contains(cnfVar)) {
+          scopeWeights[cnfVar] = Number("1");
+          scopeWeights[-cnfVar] = Number();
+        }
+      }
+      vector<Map<Int, Number>> laneWeights;
+      for (Int j = firstIndex; j < endIndex; j++) {
+        for (Int literal : {projectionVars.at(flatIndex).at(j), -projectionVars.at(flatIndex).at(j)}) {
+          laneWeights.push_back(scopeWeights);
+          laneWeights.back()[-literal] = Number();
+        }
+      }
+      vector<const Map<Int, Number>*> laneLiteralWeights;
+      for (const Map<Int, Number>& literalWeights : laneWeights) {
+        laneLiteralWeights.push_back(&literalWeights);
+      }
+      vector<Number> solutions = flatDds.at(flatIndex).second.getFullAbstractions(ddVarToCnfVarMap, laneLiteralWeights, additiveFlags);
+      const std::lock_guard<mutex> g(marginalsMutex);
+      for (Int j = firstIndex; j < endIndex; j++) {
+        Int lane = 2 * (j - firstIndex);
+        marginals.emplace(projectionVars.at(flatIndex).at(j), pair(getAdjustedSolution(solutions.at(lane)), getAdjustedSolution(solutions.at(lane + 1))));
+      }
+    }
+  };
+  vector<thread> threads;
+  for (Int threadIndex = 1; threadIndex < threadCount; threadIndex++) {
+    threads.push_back(thread(solveTasks));
+  }
+  solveTasks();
+  for (thread& t : threads) {
+    t.join();
+  }
+
+  Number solution = getAdjustedSolution(apparentSolution);
+  Number zero = logCounting ? Number(-INF) : Number();
+  for (Int var = 1; var <= cnf.declaredVarCount; var++) { // hidden vars are independent of clauses
+    if (!cnf.apparentVars.contains(var)) {
+      Float positiveWeight = cnf.literalWeights.at(var).fraction;
+      Float negativeWeight = cnf.literalWeights.at(-var).fraction;
+      Float totalWeight = positiveWeight + negativeWeight;
+      if (logCounting) {
+        marginals.insert_or_assign(var, pair(Number(solution.fraction + log10l(positiveWeight / totalWeight)), Number(solution.fraction + log10l(negativeWeight / totalWeight))));
+      }
+      else {
+        marginals.insert_or_assign(var, pair(Number(solution.fraction * positiveWeight / totalWeight), Number(solution.fraction * negativeWeight / totalWeight)));
+      }
+    }
+  }
+  for (auto it = cnf.substitutions.rbegin(); it != cnf.substitutions.rend(); it++) { // vars removed by preprocessing, last removed first
+    auto [var, literal] = *it;
+    if (literal == 0) { // var is propagated literal
+      marginals.insert_or_assign(abs(var), var > 0 ? pair(solution, zero) : pair(zero, solution));
+    }
+    else {
+      auto [positiveCount, negativeCount] = marginals.at(abs(literal));
+      marginals.insert_or_assign(var, literal > 0 ? pair(positiveCount, negativeCount) : pair(negativeCount, positiveCount));
+    }
+  }
+
+  std::ofstream marginalFileStream(marginalFilePath);
+  marginalFileStream.precision(std::numeric_limits<Float>::digits10);
+  marginalFileStream << "var,log10CountTrue,log10CountFalse,probabilityTrue\n";
+  for (Int var = 1; var <= cnf.declaredVarCount; var++) {
+    auto [positiveCount, negativeCount] = marginals.at(var);
+    Float positiveLog = logCounting ? positiveCount.fraction : positiveCount.getLog10();
+    Float negativeLog = logCounting ? negativeCount.fraction : negativeCount.getLog10();
+    Float probability = positiveLog == -INF ? 0 : 1 / (1 + exp10l(negativeLog - positiveLog));
+    marginalFileStream << var << "," << positiveLog << "," << negativeLog << "," << probability << "\n";
+  }
+  if (!marginalFileStream) {
+    throw MyError("unable to write file '", marginalFilePath, "'");
+  }
+  util::printRow("marginalDiagramCount", flatDds.size());
+  util::printRow("marginalSeconds", util::getDuration(marginalStartPoint));
+  cout << "c wrote marginals of " << cnf.declaredVarCount << " vars to file " << marginalFilePath << "\n";
+  return apparentSolution;
+}
+
+void Executor::solveWeightVectors(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap) {
+  std::ifstream weightFileStream(weightFilePath);
+  if (!weightFileStream.is_open()) {
+    throw MyError("unable to open file '", weightFilePath, "'");
+  }
+
+  Float threadMem = maxMem / threadCount;
+  util::printRow("threadMaxMemMegabytes", threadMem);
+
+  TimePoint compilationStartPoint = util::getTimePoint();
+  vector<const Cudd*> mgrs(threadCount);
+  vector<std::unique_ptr<Dd>> weightlessDds(threadCount); // nullptr if product does not fit in half of thread mem
+  vector<vector<Int>> projectionOrders(threadCount);
+  vector<std::unique_ptr<WeightlessDd>> flatDds(threadCount); // nullptr unless projection order goes from bottom level up
+  auto compile = [&](Int threadIndex) {
+    mgrs.at(threadIndex) = Dd::newMgr(threadMem, threadIndex);
+    try {
+      weightlessDds.at(threadIndex) = std::make_unique<Dd>(getWeightlessDd(joinRoot, cnfVarToDdVarMap, mgrs.at(threadIndex), threadMem * MEGA / 2));
+      projectionOrders.at(threadIndex) = getWeightlessProjectionOrder(ddVarToCnfVarMap, mgrs.at(threadIndex));
+      bool onePassFlag = true;
+      for (Int i = 1; i < projectionOrders.at(threadIndex).size(); i++) {
+        if (Dd::getVarLevel(cnfVarToDdVarMap.at(projectionOrders.at(threadIndex).at(i)), mgrs.at(threadIndex)) > Dd::getVarLevel(cnfVarToDdVarMap.at(projectionOrders.at(threadIndex).at(i - 1)), mgrs.at(threadIndex))) {
+          onePassFlag = false; // outer var below inner var
+        }
+      }
+      if (onePassFlag) {
+        flatDds.at(threadIndex) = std::make_unique<WeightlessDd>(weightlessDds.at(threadIndex)->getFlattenedDd(ddVarToCnfVarMap.size(), mgrs.at(threadIndex)));
+      }
+    }
+    catch (const MemoryExhaustionException&) { // thread re-executes join tree per weight vector
+      releaseMem(mgrs.at(threadIndex));
+    }
+  };
+  vector<thread> threads;
+  for (Int threadIndex = 1; threadIndex < threadCount; threadIndex++) {
+    threads.push_back(thread(compile, threadIndex));
+  }
+  compile(0);
+  for (thread& t : threads) {
+    t.join();
+  }
+  util::printRow("weightlessDiagramSize", weightlessDds.front() ? weightlessDds.front()->getNodeCount() : 0); // 0 if it does not fit
+  util::printRow("onePassAbstraction", flatDds.front() != nullptr);
+  util::printRow("compilationSeconds", util::getDuration(compilationStartPoint));
+
+  vector<bool> additiveFlags; // by DD var, like getProjectedDd
+  for (Int cnfVar : ddVarToCnfVarMap) {
+    additiveFlags.push_back(JoinNode::cnf.outerVars.contains(cnfVar) != existRandom);
+  }
+
+  TimePoint solvingStartPoint = util::getTimePoint();
+  Int vectorCount = 0;
+  Int lineIndex = 0;
+  string line;
+  while (true) {
+    vector<Map<Int, Number>> weightVectors;
+    while (weightVectors.size() < WEIGHT_VECTOR_BATCH_SIZE && getline(weightFileStream, line)) {
+      lineIndex++;
+      vector<string> words = util::splitInputLine(line);
+      if (words.empty() || words.front().starts_with("c")) { // comment
+        continue;
+      }
+      weightVectors.push_back(JoinNode::cnf.getFoldedLiteralWeights(JoinNode::cnf.getWeightUpdates(words, lineIndex)));
+    }
+    if (weightVectors.empty()) {
+      break;
+    }
+
+    vector<Number> solutions(weightVectors.size());
+    std::atomic<Int> nextIndex(0);
+    auto solveBatch = [&](Int threadIndex) {
+      const Cudd* mgr = mgrs.at(threadIndex);
+      if (flatDds.at(threadIndex)) { // weight vectors are taken in lane groups
+        for (Int index = nextIndex.fetch_add(weightLaneCount); index < weightVectors.size(); index = nextIndex.fetch_add(weightLaneCount)) {
+          vector<const Map<Int, Number>*> laneLiteralWeights;
+          for (Int i = index; i < min(index + weightLaneCount, static_cast<Int>(weightVectors.size())); i++) {
+            laneLiteralWeights.push_back(&weightVectors.at(i));
+          }
+          vector<Number> laneSolutions = flatDds.at(threadIndex)->getFullAbstractions(ddVarToCnfVarMap, laneLiteralWeights, additiveFlags);
+          for (Int lane = 0; lane < laneSolutions.size(); lane++) {
+            threadLiteralWeights = laneLiteralWeights.at(lane); // for hidden vars
+            solutions.at(index + lane) = getAdjustedSolution(laneSolutions.at(lane));
+          }
+          threadLiteralWeights = nullptr;
+        }
+        return;
+      }
+      for (Int index = nextIndex++; index < weightVectors.size(); index = nextIndex++) {
+        threadLiteralWeights = &weightVectors.at(index);
+        if (weightlessDds.at(threadIndex)) {
+          Dd dd = *weightlessDds.at(threadIndex);
+          for (Int cnfVar : projectionOrders.at(threadIndex)) {
+            dd = getProjectedDd(dd, cnfVar, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, Assignment());
+          }
+          solutions.at(index) = getAdjustedSolution(dd.extractConst());
+        }
+        else {
+          solutions.at(index) = getAdjustedSolution(solveSubtree(static_cast<const JoinNode*>(joinRoot), cnfVarToDdVarMap, ddVarToCnfVarMap, mgr).extractConst());
+        }
+        threadLiteralWeights = nullptr;
+      }
+    };
+    threads.clear();
+    for (Int threadIndex = 1; threadIndex < threadCount; threadIndex++) {
+      threads.push_back(thread(solveBatch, threadIndex));
+    }
+    solveBatch(0);
+    for (thread& t : threads) {
+      t.join();
+    }
+
+    for (const Number& solution : solutions) {
+      util::printRow("s vector " + to_string(++vectorCount) + " log10-estimate", logCounting ? solution.fraction : solution.getLog10(), 0);
+    }
+    cout << std::flush;
+  }
+
+  Float solvingDuration = util::getDuration(solvingStartPoint);
+  util::printRow("weightVectorCount", vectorCount);
+  util::printRow("weightVectorSeconds", solvingDuration);
+  if (solvingDuration > 0) { // rate is undefined below timer resolution
+    util::printRow("weightVectorsPerSecond", vectorCount / solvingDuration);
+  }
+}
+
+Float Executor::getBlockLogUpperBound(const Clause& clause, const Assignment& assignment) {
+  vector<Int> vars; // unassigned
+  Int trueLiteralCount = 0; // among assigned vars
+  Float assignedLogWeight = 0;
+  for (Int literal : clause) {
+    Int var = abs(literal);
+    if (assignment.contains(var)) {
+      if (assignment.at(var) == (literal > 0)) {
+        trueLiteralCount++;
+      }
+      assignedLogWeight += JoinNode::cnf.literalWeights.at(assignment.at(var) ? var : -var).getLog10();
+    }
+    else {
+      vars.push_back(var);
+    }
+  }
+
+  vector<Float> positiveWeights, negativeWeights;
+  Int positiveMask = 0; // unassigned vars whose positive literals are in clause
+  Int negativeMask = 0;
+  Int multiplicativeMask = 0;
+  for (Int i = 0; i < vars.size(); i++) {
+    Int var = vars.at(i);
+    positiveWeights.push_back(JoinNode::cnf.literalWeights.at(var).fraction);
+    negativeWeights.push_back(JoinNode::cnf.literalWeights.at(-var).fraction);
+    positiveMask |= static_cast<Int>(clause.contains(var)) << i;
+    negativeMask |= static_cast<Int>(clause.contains(-var)) << i;
+    multiplicativeMask |= static_cast<Int>(JoinNode::cnf.outerVars.contains(var) == existRandom) << i;
+  }
+
+  Map<Int, Float> maxMaskToSum; // bits of multiplicative vars |-> sum over bits of additive vars
+  for (Int bits = 0; bits < (1ll << vars.size()); bits++) {
+    Int count = trueLiteralCount + __builtin_popcountll(bits & positiveMask) + __builtin_popcountll(~bits & negativeMask);
+    if (clause.xorFlag ? count % 2 == 0 : count == 0) {
+      continue;
+    }
+    Float weight = 1;
+    for (Int i = 0; i < vars.size(); i++) {
+      weight *= (bits >> i) & 1 ? positiveWeights.at(i) : negativeWeights.at(i);
+    }
+    maxMaskToSum[bits & multiplicativeMask] += weight;
+  }
+
+  Float maxSum = 0;
+  for (const auto& [maxMask, sum] : maxMaskToSum) {
+    maxSum = max(maxSum, sum);
+  }
+  return assignedLogWeight + log10l(maxSum);
+}
+
+Float Executor::getSliceLogUpperBound(const Assignment& assignment) {
+  Float logUpperBound = 0;
+  Set<Int> blockVars; // in disjoint clauses
+  for (const Clause& clause : JoinNode::cnf.clauses) {
+    if (clause.size() > MAX_BOUNDING_CLAUSE_WIDTH) {
+      continue;
+    }
+    bool disjointFlag = true;
+    for (Int literal : clause) {
+      if (blockVars.contains(abs(literal))) {
+        disjointFlag = false;
+        break;
+      }
+    }
+    if (disjointFlag) {
+      for (Int literal : clause) {
+        blockVars.insert(abs(literal));
+      }
+      logUpperBound += getBlockLogUpperBound(clause, assignment);
+    }
+  }
+
+  for (Int var : JoinNode::cnf.apparentVars) {
+    if (blockVars.contains(var)) {
+      continue;
+    }
+    const Number& positiveWeight = JoinNode::cnf.literalWeights.at(var);
+    const Number& negativeWeight = JoinNode::cnf.literalWeights.at(-var);
+    if (assignment.contains(var)) {
+      logUpperBound += (assignment.at(var) ? positiveWeight : negativeWeight).getLog10();
+    }
+    else if (JoinNode::cnf.outerVars.contains(var) != existRandom) { // additive
+      logUpperBound += (positiveWeight + negativeWeight).getLog10();
+    }
+    else {
+      logUpperBound += max(positiveWeight, negativeWeight).getLog10();
     }
+  }
+  return logUpperBound;
+}
 
-    dd = dd.getAbstraction(ddVar, ddVarToCnfVarMap, JoinNode::cnf.literalWeights, assignment, additiveFlag, maximizationStack, mgr);
+void Executor::sortSlicesByUpperBound(vector<Assignment>& assignments) {
+  vector<pair<Float, Assignment>> boundedAssignments;
+  for (const Assignment& assignment : assignments) {
+    boundedAssignments.push_back({getSliceLogUpperBound(assignment), assignment});
+  }
+  std::stable_sort(boundedAssignments.begin(), boundedAssignments.end(), [](const pair<Float, Assignment>& a, const pair<Float, Assignment>& b) {
+    return a.first > b.first;
+  });
+  for (Int i = 0; i < assignments.size(); i++) {
+    assignments.at(i) = boundedAssignments.at(i).second;
+  }
+}
 
-    if (logBound > -INF) {
-      if (JoinNode::cnf.literalWeights.at(cnfVar) < Number(1) || JoinNode::cnf.literalWeights.at(-cnfVar) < Number(1)) {
-        Dd prunedDd = dd.getPrunedDd(logBound, mgr);
-        if (prunedDd != dd) {
-          if (verboseSolving >= 3) {
-            cout << "c writing pre-pruning decision diagram...\n";
-            dd.writeDotFile(mgr);
+bool Executor::isSliceDominated(const Assignment& assignment, const Number& totalSolution) {
+  if (!upperBoundPruning) {
+    return false;
+  }
+  Float incumbent = max(totalSolution.fraction, readLogBound()); // logBound is attained by some slice
+  return getSliceLogUpperBound(assignment) + UPPER_BOUND_TOLERANCE < incumbent;
+}
 
-            cout << "c writing post-pruning decision diagram...\n";
-            prunedDd.writeDotFile(mgr);
-          }
-          prunedDdCount++;
-          dd = prunedDd;
-        }
-      }
+void Executor::addPartialSolution(Number& totalSolution, const Number& partialSolution) {
+  if (existRandom) {
+    totalSolution = max(totalSolution, partialSolution);
+    if (boundUpdating) {
+      raiseLogBound(totalSolution.fraction); // best slice so far is lower bound of max
     }
   }
-
-  updateVarDurations(joinNode, nonterminalStartPoint);
-  updateVarDdSizes(joinNode, dd);
-
-  return dd;
+  else {
+    totalSolution = logCounting ? Number(totalSolution.getLogSumExp(partialSolution)) : totalSolution + partialSolution;
+  }
 }
 
 void Executor::solveThreadSlices(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, Float threadMem, Int threadIndex, const vector<vector<Assignment>>& threadAssignmentLists, Number& totalSolution, mutex& solutionMutex) {
   const vector<Assignment>& threadAssignments = threadAssignmentLists.at(threadIndex);
+  const Cudd* mgr = Dd::newMgr(threadMem, threadIndex); // reused across slices so that clause DDs are cached
+  Int sliceIndexOffset = 0; // slices of earlier threads
+  for (Int i = 0; i < threadIndex; i++) {
+    sliceIndexOffset += threadAssignmentLists.at(i).size();
+  }
   for (Int threadAssignmentIndex = 0; threadAssignmentIndex < threadAssignments.size(); threadAssignmentIndex++) {
     TimePoint sliceStartPoint = util::getTimePoint();
+    Profiler::threadSliceIndex = sliceIndexOffset + threadAssignmentIndex;
+
+    {
+      const std::lock_guard<mutex> g(solutionMutex);
+      if (isSliceDominated(threadAssignments.at(threadAssignmentIndex), totalSolution)) {
+        skippedSliceCount++;
+        if (verboseSolving >= 1) {
+          cout << "c thread " << right << setw(4) << threadIndex + 1 << "/" << threadAssignmentLists.size();
+          cout << " | assignment " << setw(4) << threadAssignmentIndex + 1 << "/" << threadAssignments.size();
+          cout << " | skipped (upper bound " << getSliceLogUpperBound(threadAssignments.at(threadAssignmentIndex)) << ")\n";
+        }
+        continue;
+      }
+    }
 
-    Number partialSolution = solveSubtree(static_cast<const JoinNode*>(joinRoot), cnfVarToDdVarMap, ddVarToCnfVarMap, Dd::newMgr(threadMem, threadIndex), threadAssignments.at(threadAssignmentIndex)).extractConst();
+    Number partialSolution;
+    Float partialLogErrorBound = 0;
+    bool journaledFlag = sliceJournal != nullptr && sliceJournal->getFinishedSlice(threadAssignments.at(threadAssignmentIndex), partialSolution);
+    if (!journaledFlag) {
+      Dd dd = solveSubtree(static_cast<const JoinNode*>(joinRoot), cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, threadAssignments.at(threadAssignmentIndex));
+      partialSolution = dd.extractConst();
+      partialLogErrorBound = dd.logErrorBound;
+    }
 
     const std::lock_guard<mutex> g(solutionMutex);
 
+    if (sliceJournal != nullptr && !journaledFlag) {
+      sliceJournal->addFinishedSlice(threadAssignments.at(threadAssignmentIndex), partialSolution);
+    }
+
     if (verboseSolving >= 1) {
       cout << "c thread " << right << setw(4) << threadIndex + 1 << "/" << threadAssignmentLists.size();
       cout << " | assignment " << setw(4) << threadAssignmentIndex + 1 << "/" << threadAssignments.size();
@@ -799,15 +2982,11 @@ void Executor::solveThreadSlices(const JoinNonterminal* joinRoot, const Map<Int,
       cout << "c thread " << right << setw(4) << threadIndex + 1 << "/" << threadAssignmentLists.size();
       cout << " | assignment " << setw(4) << threadAssignmentIndex + 1 << "/" << threadAssignments.size();
       cout << " | seconds " << std::fixed << setw(10) << util::getDuration(sliceStartPoint);
-      cout << " | solution " << setw(15) << partialSolution << "\n";
+      cout << " | solution " << setw(15) << partialSolution << (journaledFlag ? " (journal)" : "") << "\n";
     }
 
-    if (existRandom) {
-      totalSolution = max(totalSolution, partialSolution);
-    }
-    else {
-      totalSolution = logCounting ? Number(totalSolution.getLogSumExp(partialSolution)) : totalSolution + partialSolution;
-    }
+    addPartialSolution(totalSolution, partialSolution);
+    logErrorBound = max(logErrorBound, partialLogErrorBound); // slices are summed or maxed
   }
 }
 
@@ -836,13 +3015,22 @@ vector<vector<Assignment>> Executor::getThreadAssignmentLists(const JoinNontermi
 
   vector<Assignment> assignments = joinRoot->getOuterAssignments(sliceVarOrderHeuristic, sliceVarCount);
   vector<vector<Assignment>> threadAssignmentLists;
-  vector<Assignment> threadAssignmentList;
-  for (Int assignmentIndex = 0, threadListIndex = 0; assignmentIndex < assignments.size() && threadListIndex < threadSliceCounts.size(); assignmentIndex++) {
-    threadAssignmentList.push_back(assignments.at(assignmentIndex));
-    if (threadAssignmentList.size() == threadSliceCounts.at(threadListIndex)) {
-      threadAssignmentLists.push_back(threadAssignmentList);
-      threadAssignmentList.clear();
-      threadListIndex++;
+  if (upperBoundPruning) { // deals promising slices to all threads first
+    sortSlicesByUpperBound(assignments);
+    threadAssignmentLists.resize(threadSliceCounts.size());
+    for (Int assignmentIndex = 0; assignmentIndex < assignments.size(); assignmentIndex++) {
+      threadAssignmentLists.at(assignmentIndex % threadSliceCounts.size()).push_back(assignments.at(assignmentIndex));
+    }
+  }
+  else {
+    vector<Assignment> threadAssignmentList;
+    for (Int assignmentIndex = 0, threadListIndex = 0; assignmentIndex < assignments.size() && threadListIndex < threadSliceCounts.size(); assignmentIndex++) {
+      threadAssignmentList.push_back(assignments.at(assignmentIndex));
+      if (threadAssignmentList.size() == threadSliceCounts.at(threadListIndex)) {
+        threadAssignmentLists.push_back(threadAssignmentList);
+        threadAssignmentList.clear();
+        threadListIndex++;
+      }
     }
   }
 
@@ -862,6 +3050,263 @@ vector<vector<Assignment>> Executor::getThreadAssignmentLists(const JoinNontermi
   return threadAssignmentLists;
 }
 
+Number Executor::solveWorkerSlices(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, Int sliceVarOrderHeuristic) {
+  size_t sliceVarCount = ceill(log2l(workerProcessCount * threadSliceCount));
+  sliceVarCount = min(sliceVarCount, JoinNode::cnf.outerVars.size());
+
+  vector<Assignment> assignments = joinRoot->getOuterAssignments(sliceVarOrderHeuristic, sliceVarCount);
+  if (upperBoundPruning) {
+    sortSlicesByUpperBound(assignments);
+  }
+  util::printRow("sliceWidth", joinRoot->getWidth(assignments.front())); // any assignment would work
+  util::printRow("workerMaxMemMegabytes", maxMem);
+
+  signal(SIGPIPE, SIG_IGN); // dead workers are detected by closed response pipes
+
+  Number totalSolution = logCounting ? Number(-INF) : Number();
+  Int solvedSliceCount = 0;
+
+  std::unique_ptr<SliceJournal> journal;
+  if (!checkpointJournalPath.empty()) {
+    journal = std::make_unique<SliceJournal>(checkpointJournalPath, joinRoot, assignments);
+  }
+
+  std::queue<Int> pendingSliceIndices;
+  for (Int sliceIndex = 0; sliceIndex < assignments.size(); sliceIndex++) {
+    Number partialSolution;
+    if (journal && journal->getFinishedSlice(assignments.at(sliceIndex), partialSolution)) {
+      if (verboseSolving >= 1) {
+        cout << "c journal | assignment " << right << setw(4) << sliceIndex + 1 << "/" << assignments.size();
+        cout << " | solution " << std::fixed << setw(15) << partialSolution << "\n";
+      }
+      addPartialSolution(totalSolution, partialSolution);
+      solvedSliceCount++;
+    }
+    else {
+      pendingSliceIndices.push(sliceIndex);
+    }
+  }
+  vector<Int> sliceAttemptCounts(assignments.size(), 0);
+  Int failedAttemptCount = 0;
+
+  vector<SliceWorker> workers;
+  for (Int workerIndex = 0; workerIndex < min(workerProcessCount, static_cast<Int>(pendingSliceIndices.size())); workerIndex++) {
+    workers.push_back(SliceWorker::forkWorker(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, workerIndex, workers));
+  }
+
+  while (solvedSliceCount < assignments.size()) {
+    vector<pollfd> responsePollFds;
+    vector<Int> busyWorkerIndices;
+    for (Int workerIndex = 0; workerIndex < workers.size(); workerIndex++) {
+      SliceWorker& worker = workers.at(workerIndex);
+      while (worker.isIdle() && !pendingSliceIndices.empty() && isSliceDominated(assignments.at(pendingSliceIndices.front()), totalSolution)) {
+        Int sliceIndex = pendingSliceIndices.front();
+        pendingSliceIndices.pop();
+        skippedSliceCount++;
+        solvedSliceCount++;
+        if (verboseSolving >= 1) {
+          cout << "c coordinator | assignment " << right << setw(4) << sliceIndex + 1 << "/" << assignments.size();
+          cout << " | skipped (upper bound " << getSliceLogUpperBound(assignments.at(sliceIndex)) << ")\n";
+        }
+      }
+      if (worker.isIdle() && !pendingSliceIndices.empty()) {
+        Int sliceIndex = pendingSliceIndices.front();
+        pendingSliceIndices.pop();
+        sliceAttemptCounts.at(sliceIndex)++;
+        worker.sendSlice(sliceIndex, assignments.at(sliceIndex));
+      }
+      if (!worker.isIdle()) {
+        responsePollFds.push_back({fileno(worker.responseFile), POLLIN, 0});
+        busyWorkerIndices.push_back(workerIndex);
+      }
+    }
+
+    if (responsePollFds.empty()) { // remaining slices were skipped
+      continue;
+    }
+
+    if (poll(responsePollFds.data(), responsePollFds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw MyError("failed to poll worker processes");
+    }
+
+    for (Int pollIndex = 0; pollIndex < responsePollFds.size(); pollIndex++) {
+      if (responsePollFds.at(pollIndex).revents == 0) {
+        continue;
+      }
+      Int workerIndex = busyWorkerIndices.at(pollIndex);
+      SliceWorker& worker = workers.at(workerIndex);
+      Int sliceIndex = worker.sliceIndex;
+
+      Int respondedSliceIndex;
+      Float partialFraction;
+      if (fscanf(worker.responseFile, "%lld %La", &respondedSliceIndex, &partialFraction) == 2 && respondedSliceIndex == sliceIndex) {
+        worker.sliceIndex = MIN_INT;
+        Number partialSolution(partialFraction);
+
+        if (verboseSolving >= 1) {
+          cout << "c worker " << right << setw(4) << workerIndex + 1 << "/" << workers.size();
+          cout << " | assignment " << setw(4) << sliceIndex + 1 << "/" << assignments.size();
+
+          cout << ": { ";
+          assignments.at(sliceIndex).printAssignment();
+          cout << " }\n";
+
+          cout << "c worker " << right << setw(4) << workerIndex + 1 << "/" << workers.size();
+          cout << " | assignment " << setw(4) << sliceIndex + 1 << "/" << assignments.size();
+          cout << " | seconds " << std::fixed << setw(10) << util::getDuration(worker.sliceStartPoint);
+          cout << " | solution " << setw(15) << partialSolution << "\n";
+        }
+
+        if (journal) {
+          journal->addFinishedSlice(assignments.at(sliceIndex), partialSolution);
+        }
+        addPartialSolution(totalSolution, partialSolution);
+        solvedSliceCount++;
+        continue;
+      }
+
+      worker.stop(true); // worker died (e.g., out of mem) or sent malformed response
+      failedAttemptCount++;
+      if (verboseSolving >= 1) {
+        cout << "c worker " << right << setw(4) << workerIndex + 1 << "/" << workers.size();
+        cout << " | assignment " << setw(4) << sliceIndex + 1 << "/" << assignments.size();
+        cout << " | failed attempt " << sliceAttemptCounts.at(sliceIndex) << "/" << MAX_SLICE_ATTEMPTS << "\n";
+      }
+      if (sliceAttemptCounts.at(sliceIndex) >= MAX_SLICE_ATTEMPTS) {
+        for (SliceWorker& w : workers) {
+          if (w.pid > 0) {
+            kill(w.pid, SIGKILL);
+          }
+          w.stop();
+        }
+        throw MyError("assignment ", sliceIndex + 1, " failed in ", MAX_SLICE_ATTEMPTS, " worker processes");
+      }
+      pendingSliceIndices.push(sliceIndex);
+      workers.at(workerIndex) = SliceWorker::forkWorker(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, workerIndex, workers);
+    }
+  }
+
+  for (SliceWorker& worker : workers) {
+    worker.stop();
+  }
+  util::printRow("failedSliceAttempts", failedAttemptCount);
+
+  return totalSolution;
+}
+
+Number Executor::solveComponents(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap) {
+  vector<Int> varComponents = JoinNode::cnf.getVarComponents();
+
+  Map<Int, Int> componentParents; // union-find over components, as a child of root may span several components
+  auto findRoot = [&componentParents](Int component) {
+    while (componentParents.at(component) != component) {
+      component = componentParents.at(component);
+    }
+    return component;
+  };
+  vector<Int> childComponents; // child index |-> some component in child (MIN_INT if child has no var)
+  for (const JoinNode* child : joinRoot->children) {
+    Int childComponent = MIN_INT;
+    for (Int var : child->preProjectionVars) {
+      Int component = varComponents.at(var);
+      componentParents.try_emplace(component, component);
+      if (childComponent == MIN_INT) {
+        childComponent = component;
+      }
+      else {
+        Int root = findRoot(childComponent);
+        Int otherRoot = findRoot(component);
+        componentParents.at(max(root, otherRoot)) = min(root, otherRoot);
+      }
+    }
+    childComponents.push_back(childComponent);
+  }
+  for (Int var : joinRoot->projectionVars) { // var in no child is still projected (as a constant factor) with its component
+    componentParents.try_emplace(varComponents.at(var), varComponents.at(var));
+  }
+
+  Map<Int, Int> groupIndices; // component root |-> group index
+  vector<vector<const JoinNode*>> groupChildren;
+  vector<vector<Int>> groupProjectionVars;
+  auto addGroup = [&]() {
+    groupChildren.push_back(vector<const JoinNode*>());
+    groupProjectionVars.push_back(vector<Int>());
+    return groupChildren.size() - 1;
+  };
+  auto getGroupIndex = [&](Int component) {
+    Int root = findRoot(component);
+    if (!groupIndices.contains(root)) {
+      groupIndices[root] = addGroup();
+    }
+    return groupIndices.at(root);
+  };
+  for (Int childIndex = 0; childIndex < joinRoot->children.size(); childIndex++) {
+    Int childComponent = childComponents.at(childIndex);
+    Int groupIndex = childComponent == MIN_INT ? addGroup() : getGroupIndex(childComponent); // child with no var (e.g., fully projected component) is a group by itself
+    groupChildren.at(groupIndex).push_back(joinRoot->children.at(childIndex));
+  }
+  for (Int var : joinRoot->projectionVars) { // keeps projection order of solveSubtree within each group
+    groupProjectionVars.at(getGroupIndex(varComponents.at(var))).push_back(var);
+  }
+
+  Int groupCount = groupChildren.size();
+  Int groupThreadCount = max(min(threadCount, groupCount), 1LL);
+  Float threadMem = maxMem / groupThreadCount;
+  util::printRow("componentCount", groupCount);
+  util::printRow("threadMaxMemMegabytes", threadMem);
+
+  vector<Number> groupSolutions(groupCount);
+  vector<Float> groupLogErrorBounds(groupCount);
+  std::atomic<Int> nextGroupIndex(0);
+  mutex outputMutex;
+  auto solveGroups = [&](Int threadIndex) {
+    const Cudd* mgr = Dd::newMgr(threadMem, threadIndex);
+    for (Int groupIndex = nextGroupIndex++; groupIndex < groupCount; groupIndex = nextGroupIndex++) {
+      TimePoint groupStartPoint = util::getTimePoint();
+      Profiler::threadSliceIndex = groupIndex;
+
+      Dd dd = Dd::getOneDd(mgr);
+      for (const JoinNode* child : groupChildren.at(groupIndex)) {
+        dd = dd.getProduct(solveSubtree(child, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr));
+      }
+      updatePeakDdSize(dd);
+      for (Int cnfVar : groupProjectionVars.at(groupIndex)) {
+        dd = getProjectedDd(dd, cnfVar, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, Assignment());
+      }
+      groupSolutions.at(groupIndex) = dd.extractConst();
+      groupLogErrorBounds.at(groupIndex) = dd.logErrorBound;
+
+      if (verboseSolving >= 1) {
+        const std::lock_guard<mutex> g(outputMutex);
+        cout << "c thread " << right << setw(4) << threadIndex + 1 << "/" << groupThreadCount;
+        cout << " | component " << setw(4) << groupIndex + 1 << "/" << groupCount;
+        cout << " | seconds " << std::fixed << setw(10) << util::getDuration(groupStartPoint);
+        cout << " | solution " << setw(15) << groupSolutions.at(groupIndex) << "\n";
+      }
+    }
+  };
+
+  vector<thread> threads;
+  for (Int threadIndex = 1; threadIndex < groupThreadCount; threadIndex++) {
+    threads.push_back(thread(solveGroups, threadIndex));
+  }
+  solveGroups(0);
+  for (thread& t : threads) {
+    t.join();
+  }
+
+  Number totalSolution = logCounting ? Number() : Number("1");
+  for (Int groupIndex = 0; groupIndex < groupCount; groupIndex++) {
+    const Number& groupSolution = groupSolutions.at(groupIndex);
+    totalSolution = logCounting ? totalSolution + groupSolution : totalSolution * groupSolution; // product of component solutions
+    logErrorBound += groupLogErrorBounds.at(groupIndex);
+  }
+  return totalSolution;
+}
+
 Number Executor::solveCnf(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, Int sliceVarOrderHeuristic) {
   if (ddPackage == SYLVAN) {
     return solveSubtree(
@@ -871,11 +3316,29 @@ Number Executor::solveCnf(const JoinNonterminal* joinRoot, const Map<Int, Int>&
     ).extractConst();
   }
 
+  if (workerProcessCount > 0) {
+    return solveWorkerSlices(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, sliceVarOrderHeuristic);
+  }
+
+  if (componentDecomposition) { // components take the place of slices
+    return solveComponents(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap);
+  }
+
   vector<vector<Assignment>> threadAssignmentLists = getThreadAssignmentLists(joinRoot, sliceVarOrderHeuristic);
   util::printRow("sliceWidth", joinRoot->getWidth(threadAssignmentLists.front().front())); // any assignment would work
   Number totalSolution = logCounting ? Number(-INF) : Number();
   mutex solutionMutex;
 
+  std::unique_ptr<SliceJournal> journal;
+  if (!checkpointJournalPath.empty()) {
+    vector<Assignment> assignments;
+    for (const vector<Assignment>& threadAssignments : threadAssignmentLists) {
+      assignments.insert(assignments.end(), threadAssignments.begin(), threadAssignments.end());
+    }
+    journal = std::make_unique<SliceJournal>(checkpointJournalPath, joinRoot, assignments);
+    sliceJournal = journal.get();
+  }
+
   Float threadMem = maxMem / threadAssignmentLists.size();
   util::printRow("threadMaxMemMegabytes", threadMem);
 
@@ -908,36 +3371,81 @@ Number Executor::solveCnf(const JoinNonterminal* joinRoot, const Map<Int, Int>&
   for (thread& t : threads) {
     t.join();
   }
+  sliceJournal = nullptr;
 
   return totalSolution;
 }
 
+Assignment Executor::searchLocally(const Cnf& cnf) {
+  TimePoint localSearchStartPoint = util::getTimePoint();
+
+  Assignment bestModel;
+  Float bestLogWeight = -INF;
+  mutex bestMutex;
+
+  vector<thread> threads;
+  for (Int threadIndex = 0; threadIndex < threadCount; threadIndex++) {
+    threads.push_back(thread([&cnf, &bestModel, &bestLogWeight, &bestMutex, threadIndex] {
+      LocalSearcher(cnf, randomSeed + threadIndex).search(localSearchDuration, bestModel, bestLogWeight, bestMutex);
+    }));
+  }
+  for (thread& t : threads) {
+    t.join();
+  }
+
+  util::printRow("localSearchLogWeight", bestLogWeight); // -inf if no model found
+  util::printRow("localSearchSeconds", util::getDuration(localSearchStartPoint));
+  return bestModel;
+}
+
 void Executor::setLogBound(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap) {
+  const Cudd* mgr = nullptr; // one manager for all models, created on first use, so that clause DDs are reused
+  auto getModelLogValue = [&](const Assignment& model) {
+    if (mgr == nullptr && ddPackage == CUDD) {
+      mgr = Dd::newMgr(maxMem);
+    }
+    return solveSubtree(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, model).extractConst().fraction;
+  };
+
   if (logBound > -INF) {} // LOG_BOUND_OPTION
   else if (!thresholdModel.empty()) { // THRESHOLD_MODEL_OPTION
-    logBound = solveSubtree(
-      joinRoot,
-      cnfVarToDdVarMap,
-      ddVarToCnfVarMap,
-      Dd::newMgr(maxMem),
-      Assignment(thresholdModel)
-    ).extractConst().fraction;
+    logBound = getModelLogValue(Assignment(thresholdModel));
     util::printRow("logBound", logBound);
   }
   else if (existPruning) { // EXIST_PRUNING_OPTION
     SatSolver satSolver(joinRoot->cnf);
     satSolver.checkSat(true);
     Assignment model = satSolver.getModel();
-    logBound = solveSubtree(
-      joinRoot,
-      cnfVarToDdVarMap,
-      ddVarToCnfVarMap,
-      Dd::newMgr(maxMem),
-      model
-    ).extractConst().fraction;
+    logBound = getModelLogValue(model);
     util::printRow("logBound", logBound);
     cout << "c " << getShortModel(model, joinRoot->cnf.declaredVarCount) << "\n";
   }
+
+  if (localSearchDuration > 0) { // LOCAL_SEARCH_OPTION
+    Assignment model = searchLocally(joinRoot->cnf);
+    if (!model.empty()) {
+      raiseLogBound(getModelLogValue(model));
+      util::printRow("logBound", logBound);
+      if (verboseSolving >= 2) {
+        cout << "c " << getShortModel(model, joinRoot->cnf.declaredVarCount) << "\n";
+      }
+    }
+  }
+
+  if (boundUpdating) { // BOUND_UPDATING_OPTION
+    SatSolver satSolver(joinRoot->cnf);
+    Int modelCount = 0;
+    for (; modelCount < boundUpdating && satSolver.checkSat(false); modelCount++) {
+      Assignment model = satSolver.getModel(); // banned for next iteration
+      raiseLogBound(getModelLogValue(model));
+    }
+    util::printRow("boundModelCount", modelCount);
+    util::printRow("initialLogBound", logBound);
+  }
+
+  if (mgr != nullptr) {
+    deleteMgr(mgr);
+  }
 }
 
 Number Executor::adjustSolutionToHiddenVar(const Number &apparentSolution, Int cnfVar, bool additiveFlag) {
@@ -945,8 +3453,8 @@ Number Executor::adjustSolutionToHiddenVar(const Number &apparentSolution, Int c
     return apparentSolution;
   }
 
-  const Number& positiveWeight = JoinNode::cnf.literalWeights.at(cnfVar);
-  const Number& negativeWeight = JoinNode::cnf.literalWeights.at(-cnfVar);
+  const Number& positiveWeight = getLiteralWeights().at(cnfVar);
+  const Number& negativeWeight = getLiteralWeights().at(-cnfVar);
   if (additiveFlag) {
     return logCounting ? apparentSolution + (positiveWeight + negativeWeight).getLog10() : apparentSolution * (positiveWeight + negativeWeight);
   }
@@ -1013,6 +3521,9 @@ void Executor::printTypeRow(size_t keyWidth) {
 
 void Executor::printEstRow(const Number& solution, size_t keyWidth) {
   util::printRow("s log10-estimate", logCounting ? solution.fraction : solution.getLog10(), keyWidth);
+  if (approximationTolerance > 0) {
+    util::printRow("s log10-error-bound", logErrorBound, keyWidth); // |log10-estimate - log10(sol)| is at most this
+  }
 }
 
 void Executor::printArbRow(const Number& solution, bool frac, size_t keyWidth) {
@@ -1086,7 +3597,7 @@ void Executor::printLongMaximizer(const Assignment& maximizer, Int declaredVarCo
   cout << "\n";
 }
 
-Assignment Executor::printMaximizerRows(const vector<Int>& ddVarToCnfVarMap, Int declaredVarCount) {
+Assignment Executor::getStackMaximizer(const vector<Int>& ddVarToCnfVarMap) {
   vector<int> ddVarAssignment(ddVarToCnfVarMap.size(), -1); // uses init value -1 (neither 0 nor 1) to test assertion in function Cudd_Eval
   Assignment cnfVarAssignment;
 
@@ -1102,21 +3613,82 @@ Assignment Executor::printMaximizerRows(const vector<Int>& ddVarToCnfVarMap, Int
     maximizationStack.pop_back();
   }
 
+  return cnfVarAssignment;
+}
+
+void Executor::extractSubtreeMaximizer(const JoinNode* joinNode, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr, Assignment& maximizer) {
+  if (joinNode->isTerminal()) {
+    return;
+  }
+
+  vector<Int> additiveVars;
+  vector<Int> maximizedVars;
+  for (Int cnfVar : joinNode->projectionVars) {
+    bool additiveFlag = JoinNode::cnf.outerVars.contains(cnfVar);
+    if (existRandom) {
+      additiveFlag = !additiveFlag;
+    }
+    if (additiveFlag) {
+      additiveVars.push_back(cnfVar);
+    }
+    else if (!maximizer.contains(cnfVar)) {
+      maximizedVars.push_back(cnfVar);
+    }
+  }
+
+  if (!maximizedVars.empty()) {
+    Dd dd = Dd::getOneDd(mgr);
+    for (JoinNode* child : joinNode->children) {
+      dd = dd.getProduct(solveSubtree(child, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, maximizer)); // ancestors' maximized vars are fixed
+    }
+    for (Int cnfVar : additiveVars) { // inner vars are projected before outer vars
+      dd = dd.getAbstraction(cnfVarToDdVarMap.at(cnfVar), ddVarToCnfVarMap, JoinNode::cnf.literalWeights, maximizer, true, maximizationStack, mgr);
+    }
+    for (Int cnfVar : maximizedVars) { // applies literal weights as in Dd::getAbstraction
+      Int ddVar = cnfVarToDdVarMap.at(cnfVar);
+      Dd positiveTerm = Dd::getVarDd(ddVar, true, mgr).getProduct(Dd::getConstDd(JoinNode::cnf.literalWeights.at(cnfVar), mgr));
+      Dd negativeTerm = Dd::getVarDd(ddVar, false, mgr).getProduct(Dd::getConstDd(JoinNode::cnf.literalWeights.at(-cnfVar), mgr));
+      dd = dd.getProduct(positiveTerm.getSum(negativeTerm));
+    }
+
+    vector<int> maxCube = dd.getMaxCube(mgr);
+    for (Int cnfVar : maximizedVars) {
+      Int ddVar = cnfVarToDdVarMap.at(cnfVar);
+      maximizer.insert({cnfVar, ddVar >= maxCube.size() || maxCube.at(ddVar) != 0}); // ties go to true as in Dd::getBoolDiff
+    }
+  }
+
+  for (JoinNode* child : joinNode->children) {
+    extractSubtreeMaximizer(child, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, maximizer);
+  }
+}
+
+Assignment Executor::getTopDownMaximizer(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap) {
+  TimePoint extractionStartPoint = util::getTimePoint();
+
+  Assignment maximizer;
+  extractSubtreeMaximizer(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, Dd::newMgr(maxMem), maximizer);
+
+  if (verboseSolving >= 1) {
+    util::printRow("maximizerExtractionSeconds", util::getDuration(extractionStartPoint));
+  }
+  return maximizer;
+}
+
+void Executor::printMaximizerRows(const Assignment& maximizer, Int declaredVarCount) {
   switch (maximizerFormat) {
     case NONE:
       break;
     case SHORT:
-      printShortMaximizer(cnfVarAssignment, declaredVarCount);
+      printShortMaximizer(maximizer, declaredVarCount);
       break;
     case LONG:
-      printLongMaximizer(cnfVarAssignment, declaredVarCount);
+      printLongMaximizer(maximizer, declaredVarCount);
       break;
     default:
-      printShortMaximizer(cnfVarAssignment, declaredVarCount);
-      printLongMaximizer(cnfVarAssignment, declaredVarCount);
+      printShortMaximizer(maximizer, declaredVarCount);
+      printLongMaximizer(maximizer, declaredVarCount);
   }
-
-  return cnfVarAssignment;
 }
 
 Number Executor::verifyMaximizer(
@@ -1152,17 +3724,56 @@ Executor::Executor(const JoinNonterminal* joinRoot, Int ddVarOrderHeuristic, Int
     cnfVarToDdVarMap[cnfVar] = ddVar;
   }
 
+  if (!compiledCnfPath.empty()) {
+    writeCompiledCnf(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap);
+  }
+
+  if (!weightFilePath.empty()) {
+    solveWeightVectors(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap);
+    return;
+  }
+
   setLogBound(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap);
 
-  Number solution = solveCnf(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, sliceVarOrderHeuristic);
+  Number solution = marginalFilePath.empty() ? solveCnf(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, sliceVarOrderHeuristic) : solveMarginals(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap);
 
   printVarDurations();
   printVarDdSizes();
+  Profiler::writeFiles();
 
   if (verboseSolving >= 1) {
     util::printRow("apparentSolution", solution);
   }
 
+  if (joinTreeOptimization) {
+    util::printRow("peakDiagramSize", peakDdSize.load());
+  }
+
+  if (dynamicReordering) {
+    util::printRow("reorderingCount", reorderingCount);
+    util::printRow("reorderingSeconds", reorderingDuration);
+    util::printRow("preReorderingNodeCount", preReorderingNodeCount);
+    util::printRow("postReorderingNodeCount", postReorderingNodeCount);
+  }
+
+  if (upperBoundPruning) {
+    util::printRow("skippedSliceCount", skippedSliceCount);
+  }
+
+  util::printRow("clauseDdCount", clauseDdCount);
+  util::printRow("clauseDdCacheHitCount", clauseDdCacheHitCount);
+
+  if (memoryGovernor > 0) {
+    util::printRow("governorCollectionCount", MemoryGovernor::collectionCount);
+    util::printRow("governorGrowthCapCount", MemoryGovernor::growthCapCount);
+    util::printRow("governorExhaustionCount", MemoryGovernor::exhaustionCount);
+    util::printRow("reslicedSubtreeCount", MemoryGovernor::reslicedSubtreeCount);
+  }
+
+  if (approximationTolerance > 0) {
+    util::printRow("roundedDdCount", roundedDdCount);
+  }
+
   if (logBound > -INF) {
     util::printRow("prunedDdCount", prunedDdCount);
     util::printRow("pruningSeconds", Dd::pruningDuration);
@@ -1171,7 +3782,9 @@ Executor::Executor(const JoinNonterminal* joinRoot, Int ddVarOrderHeuristic, Int
   solution = printAdjustedSolutionRows(solution);
 
   if (maximizerFormat) {
-    Assignment maximizer = printMaximizerRows(ddVarToCnfVarMap, joinRoot->cnf.declaredVarCount);
+    Assignment maximizer = maximizerExtraction == TOP_DOWN ? getTopDownMaximizer(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap) : getStackMaximizer(ddVarToCnfVarMap);
+    JoinNode::cnf.extendAssignment(maximizer);
+    printMaximizerRows(maximizer, joinRoot->cnf.declaredVarCount);
     if (maximizerVerification) {
       TimePoint maximizerVerificationStartPoint = util::getTimePoint();
       Number maximizerSolution = verifyMaximizer(
@@ -1203,6 +3816,28 @@ string OptionDict::helpMaximizerFormat() {
   return s + "; int";
 }
 
+string OptionDict::helpMaximizerExtraction() {
+  string s = "maximizer extraction" + util::useOption(MAXIMIZER_FORMAT_OPTION, to_string(NONE), ">") + ": ";
+  for (auto it = MAXIMIZER_EXTRACTIONS.begin(); it != MAXIMIZER_EXTRACTIONS.end(); it++) {
+    s += to_string(it->first) + "/" + it->second;
+    if (next(it) != MAXIMIZER_EXTRACTIONS.end()) {
+      s += ", ";
+    }
+  }
+  return s + "; int";
+}
+
+string OptionDict::helpDynamicReordering() {
+  string s = "dynamic diagram var reordering at join nodes" + util::useDdPackage(CUDD) + ": ";
+  for (auto it = DYNAMIC_REORDERINGS.begin(); it != DYNAMIC_REORDERINGS.end(); it++) {
+    s += to_string(it->first) + "/" + it->second;
+    if (next(it) != DYNAMIC_REORDERINGS.end()) {
+      s += ", ";
+    }
+  }
+  return s + "; int";
+}
+
 string OptionDict::helpDdPackage() {
   string s = "diagram package: ";
   for (auto it = DD_PACKAGES.begin(); it != DD_PACKAGES.end(); it++) {
@@ -1230,12 +3865,25 @@ void OptionDict::runCommand() const {
     cout << "c processing command-line options...\n";
     util::printRow("cnfFile", cnfFilePath);
     util::printRow("weightedCounting", weightedCounting);
+    if (!weightFilePath.empty()) {
+      util::printRow("weightFile", weightFilePath);
+      util::printRow("weightLaneCount", weightLaneCount);
+    }
+    if (!compiledCnfPath.empty()) {
+      util::printRow("compiledCnfFile", compiledCnfPath);
+    }
+    if (!marginalFilePath.empty()) {
+      util::printRow("marginalFile", marginalFilePath);
+    }
     util::printRow("projectedCounting", projectedCounting);
     util::printRow("existRandom", existRandom);
     util::printRow("diagramPackage", DD_PACKAGES.at(ddPackage));
     if (ddPackage == CUDD) {
       util::printRow("logCounting", logCounting);
     }
+    if (logCounting) {
+      util::printRow("approximationTolerance", approximationTolerance);
+    }
     if (!projectedCounting && existRandom && logCounting) {
       if (logBound > -INF) {
         util::printRow("logBound", logBound);
@@ -1246,12 +3894,22 @@ void OptionDict::runCommand() const {
       else if (existPruning) {
         util::printRow("existPruning", existPruning);
       }
+      if (upperBoundPruning) {
+        util::printRow("upperBoundPruning", upperBoundPruning);
+      }
+      if (localSearchDuration > 0) {
+        util::printRow("localSearchDuration", localSearchDuration);
+      }
+      if (boundUpdating) {
+        util::printRow("boundUpdating", boundUpdating);
+      }
     }
     if (existRandom && ddPackage == CUDD) {
       util::printRow("maximizerFormat", MAXIMIZER_FORMATS.at(maximizerFormat));
     }
     if (maximizerFormat) {
       util::printRow("maximizerVerification", maximizerVerification);
+      util::printRow("maximizerExtraction", MAXIMIZER_EXTRACTIONS.at(maximizerExtraction));
     }
     if (!weightedCounting && maximizerFormat) {
       util::printRow("substitutionMaximization", substitutionMaximization);
@@ -1260,6 +3918,9 @@ void OptionDict::runCommand() const {
     util::printRow("threadCount", threadCount);
     if (ddPackage == CUDD) {
       util::printRow("threadSliceCount", threadSliceCount);
+      if (workerProcessCount) {
+        util::printRow("workerProcessCount", workerProcessCount);
+      }
     }
     util::printRow("randomSeed", randomSeed);
     util::printRow("diagramVarOrderHeuristic", (ddVarOrderHeuristic < 0 ? "INVERSE_" : "") + CNF_VAR_ORDER_HEURISTICS.at(abs(ddVarOrderHeuristic)));
@@ -1268,12 +3929,32 @@ void OptionDict::runCommand() const {
       util::printRow("memSensitivityMegabytes", memSensitivity);
     }
     util::printRow("maxMemMegabytes", maxMem);
+    if (memoryGovernor > 0) {
+      util::printRow("memoryGovernor", memoryGovernor);
+    }
+    if (dynamicReordering) {
+      util::printRow("dynamicReordering", DYNAMIC_REORDERINGS.at(dynamicReordering));
+      util::printRow("reorderingThreshold", reorderingThreshold);
+    }
     if (ddPackage == SYLVAN) {
       util::printRow("tableRatio", tableRatio);
       util::printRow("initRatio", initRatio);
       util::printRow("multiplePrecision", multiplePrecision);
     }
     util::printRow("joinPriority", JOIN_PRIORITIES.at(joinPriority));
+    util::printRow("joinTreeOptimization", joinTreeOptimization);
+    if (!joinTreeCacheDir.empty()) {
+      util::printRow("joinTreeCacheDir", joinTreeCacheDir);
+    }
+    if (!checkpointJournalPath.empty()) {
+      util::printRow("checkpointJournal", checkpointJournalPath);
+    }
+    if (!profileFilePrefix.empty()) {
+      util::printRow("profileFilePrefix", profileFilePrefix);
+    }
+    util::printRow("xorElimination", xorElimination);
+    util::printRow("preprocessing", preprocessing);
+    util::printRow("componentDecomposition", componentDecomposition);
     cout << "\n";
   }
 
@@ -1283,6 +3964,11 @@ void OptionDict::runCommand() const {
     if (JoinNode::cnf.clauses.empty()) {
       cout << WARNING << "empty CNF\n";
       Executor::printAdjustedSolutionRows(logCounting ? Number() : Number("1"));
+      if (maximizerFormat) { // all vars are hidden
+        Assignment maximizer;
+        JoinNode::cnf.extendAssignment(maximizer);
+        Executor::printMaximizerRows(maximizer, JoinNode::cnf.declaredVarCount);
+      }
       return;
     }
 
@@ -1297,11 +3983,20 @@ void OptionDict::runCommand() const {
       if (multiplePrecision) {
         sylvan::gmp_init();
       }
+      if (memoryGovernor > 0) {
+        sylvan::sylvan_gc_hook_postgc(MemoryGovernor::updateTableFill);
+      }
     }
 
-    Executor executor(joinTreeProcessor.getJoinTreeRoot(), ddVarOrderHeuristic, sliceVarOrderHeuristic);
+    const JoinNonterminal* joinRoot = joinTreeProcessor.getJoinTreeRoot();
+    if (joinTreeOptimization) {
+      joinRoot = JoinTreeDraft::getOptimizedJoinRoot(joinRoot);
+    }
+
+    Executor executor(joinRoot, ddVarOrderHeuristic, sliceVarOrderHeuristic);
 
     if (ddPackage == SYLVAN) { // quits Sylvan
+      Executor::clauseDdCaches.clear(); // unprotects cached MTBDDs first
       sylvan::sylvan_quit();
       lace_exit();
     }
@@ -1317,31 +4012,51 @@ OptionDict::OptionDict(int argc, char** argv) {
   options.add_options()
     (CNF_FILE_OPTION, "CNF file path; string (REQUIRED)", value<string>())
     (WEIGHTED_COUNTING_OPTION, "weighted counting: 0, 1; int", value<Int>()->default_value("0"))
+    (WEIGHT_FILE_OPTION, "weight-vector file for batch mode (one line '{literal} {weight} ... 0' per vector, overriding CNF weights), or empty for one solve" + util::useOption(WEIGHTED_COUNTING_OPTION, "1") + "; string", value<string>()->default_value(""))
+    (MARGINAL_FILE_OPTION, "marginal file (CSV of log10 counts with each var true and false, by upward and downward passes over join tree), or empty for none; string", value<string>()->default_value(""))
+    (COMPILED_CNF_OPTION, "compiled CNF file to write for dmq (weightless diagram, var maps, weights), or empty for none; string", value<string>()->default_value(""))
+    (WEIGHT_LANE_OPTION, "weight vectors evaluated per pass over weightless diagram (batch mode and marginals); int", value<Int>()->default_value("8"))
     (PROJECTED_COUNTING_OPTION, "projected counting: 0, 1; int", value<Int>()->default_value("0"))
     (EXIST_RANDOM_OPTION, "existential-randomized stochastic satisfiability: 0, 1; int", value<Int>()->default_value("0"))
     (DD_PACKAGE_OPTION, helpDdPackage(), value<string>()->default_value(CUDD))
     (LOG_COUNTING_OPTION, "logarithmic counting" + util::useDdPackage(CUDD) + ": 0, 1; int", value<Int>()->default_value("0"))
+    (APPROXIMATION_OPTION, "approximation tolerance: relative difference within which terminals are merged at join nodes, or 0 for exact counting" + util::useOption(LOG_COUNTING_OPTION, "1") + "; float", value<Float>()->default_value("0"))
     (LOG_BOUND_OPTION, "log10 of bound for existential pruning" + util::useOption(EXIST_RANDOM_OPTION, "1") + "; float", value<string>()->default_value(to_string(-INF))) // cxxopts fails to parse "-inf" as Float
     (THRESHOLD_MODEL_OPTION, "threshold model for existential pruning" + util::useOption(EXIST_RANDOM_OPTION, "1") + "; string", value<string>()->default_value(""))
     (EXIST_PRUNING_OPTION, "existential pruning using CryptoMiniSat" + util::useOption(EXIST_RANDOM_OPTION, "1") + ": 0, 1; int", value<Int>()->default_value("0"))
+    (UPPER_BOUND_OPTION, "upper-bound slice pruning" + util::useOption(EXIST_RANDOM_OPTION, "1") + ": 0, 1; int", value<Int>()->default_value("0"))
+    (LOCAL_SEARCH_OPTION, "local search duration (in seconds, per thread) for existential-pruning bound" + util::useOption(EXIST_RANDOM_OPTION, "1") + "; float", value<Float>()->default_value("0.0"))
+    (BOUND_UPDATING_OPTION, "bound updating for existential pruning by completed slices after this many SAT models, or 0 for fixed bound" + util::useOption(EXIST_RANDOM_OPTION, "1") + "; int", value<Int>()->default_value("0"))
     (MAXIMIZER_FORMAT_OPTION, helpMaximizerFormat(), value<Int>()->default_value(to_string(NONE)))
     (MAXIMIZER_VERIFICATION_OPTION, "maximizer verification" + util::useOption(MAXIMIZER_FORMAT_OPTION, to_string(NONE), ">") + ": 0, 1; int", value<Int>()->default_value("0"))
+    (MAXIMIZER_EXTRACTION_OPTION, helpMaximizerExtraction(), value<Int>()->default_value(to_string(DERIVATIVE_SIGNS)))
     (SUBSTITUTION_MAXIMIZATION_OPTION, "substitution-based maximization" + util::useOption(MAXIMIZER_FORMAT_OPTION, to_string(NONE), ">") + ": 0, 1; int", value<Int>()->default_value("0"))
     (PLANNER_WAIT_OPTION, "planner wait duration (in seconds); float", value<Float>()->default_value("0.0"))
     (THREAD_COUNT_OPTION, "thread count, or 0 for hardware_concurrency value; int", value<Int>()->default_value("1"))
     (THREAD_SLICE_COUNT_OPTION, "thread slice count" + util::useDdPackage(CUDD) + "; int", value<Int>()->default_value("1"))
+    (WORKER_PROCESS_COUNT_OPTION, "worker process count, each with full " + MAX_MEM_OPTION + " cap, or 0 for threads" + util::useDdPackage(CUDD) + "; int", value<Int>()->default_value("0"))
     (RANDOM_SEED_OPTION, "random seed; int", value<Int>()->default_value("0"))
     (DD_VAR_OPTION, util::helpVarOrderHeuristic("diagram"), value<Int>()->default_value(to_string(MCS)))
     (SLICE_VAR_OPTION, util::helpVarOrderHeuristic("slice"), value<Int>()->default_value(to_string(BIGGEST_NODE)))
     (MEM_SENSITIVITY_OPTION, "mem sensitivity (in MB) for reporting usage" + util::useDdPackage(CUDD) + "; float", value<Float>()->default_value("1e3"))
     (MAX_MEM_OPTION, "max mem (in MB) for unique table and cache table combined; float", value<Float>()->default_value("4e3"))
+    (MEMORY_GOVERNOR_OPTION, "memory governor: fraction of each manager's " + MAX_MEM_OPTION + " share (CUDD) or live fraction of node table after GC (Sylvan, above 0.5) at which subtrees are re-sliced instead of aborting, or 0 for none; float", value<Float>()->default_value("0"))
+    (DYNAMIC_REORDERING_OPTION, helpDynamicReordering(), value<Int>()->default_value(to_string(NONE)))
+    (REORDERING_THRESHOLD_OPTION, "live diagram nodes before first reordering" + util::useOption(DYNAMIC_REORDERING_OPTION, to_string(NONE), ">") + "; int", value<Int>()->default_value("100000"))
     (TABLE_RATIO_OPTION, "table ratio" + util::useDdPackage(SYLVAN) + ": log2(unique_size/cache_size); int", value<Int>()->default_value("1"))
     (INIT_RATIO_OPTION, "init ratio for tables" + util::useDdPackage(SYLVAN) + ": log2(max_size/init_size); int", value<Int>()->default_value("10"))
     (MULTIPLE_PRECISION_OPTION, "multiple precision" + util::useDdPackage(SYLVAN) + ": 0, 1; int", value<Int>()->default_value("0"))
     (JOIN_PRIORITY_OPTION, helpJoinPriority(), value<string>()->default_value(SMALLEST_PAIR))
+    (JOIN_TREE_OPTIMIZATION_OPTION, "join tree optimization (binarizing, pushing projections down, merging chains, rerooting): 0, 1; int", value<Int>()->default_value("0"))
+    (JOIN_TREE_CACHE_OPTION, "join tree cache dir (empty for no cache); string", value<string>()->default_value(""))
+    (XOR_ELIMINATION_OPTION, "Gaussian elimination over XOR clauses (must match planner): 0, 1; int", value<Int>()->default_value("0"))
+    (PREPROCESSING_OPTION, "preprocessing (units, equivalent literals, subsumed clauses) (must match planner): 0, 1; int", value<Int>()->default_value("0"))
+    (COMPONENT_DECOMPOSITION_OPTION, "component decomposition (connected components under root solved in parallel instead of slices): 0, 1; int", value<Int>()->default_value("0"))
+    (CHECKPOINT_JOURNAL_OPTION, "checkpoint journal file for resuming sliced execution (empty for no journal)" + util::useDdPackage(CUDD) + "; string", value<string>()->default_value(""))
     (VERBOSE_CNF_OPTION, "verbose CNF processing: " + INPUT_VERBOSITY_LEVELS, value<Int>()->default_value("0"))
     (VERBOSE_JOIN_TREE_OPTION, "verbose join-tree processing: " + INPUT_VERBOSITY_LEVELS, value<Int>()->default_value("0"))
     (VERBOSE_PROFILING_OPTION, "verbose profiling: 0, 1, 2; int", value<Int>()->default_value("0"))
+    (PROFILE_FILE_OPTION, "profile file prefix for {prefix}.json (Chrome trace events), {prefix}.csv, and {prefix}.vars.csv (empty for no profile); string", value<string>()->default_value(""))
     (VERBOSE_SOLVING_OPTION, util::helpVerboseSolving(), value<Int>()->default_value("1"))
   ;
   cxxopts::ParseResult result = options.parse(argc, argv);
@@ -1350,6 +4065,17 @@ OptionDict::OptionDict(int argc, char** argv) {
 
     weightedCounting = result[WEIGHTED_COUNTING_OPTION].as<Int>(); // global var
 
+    weightFilePath = result[WEIGHT_FILE_OPTION].as<string>(); // global var
+    assert(weightFilePath.empty() || weightedCounting);
+
+    weightLaneCount = result[WEIGHT_LANE_OPTION].as<Int>(); // global var
+    assert(weightLaneCount > 0);
+
+    compiledCnfPath = result[COMPILED_CNF_OPTION].as<string>(); // global var
+
+    marginalFilePath = result[MARGINAL_FILE_OPTION].as<string>(); // global var
+    assert(marginalFilePath.empty() || weightFilePath.empty());
+
     projectedCounting = result[PROJECTED_COUNTING_OPTION].as<Int>(); // global var
 
     existRandom = result[EXIST_RANDOM_OPTION].as<Int>(); // global var
@@ -1360,6 +4086,10 @@ OptionDict::OptionDict(int argc, char** argv) {
     logCounting = result[LOG_COUNTING_OPTION].as<Int>(); // global var
     assert(!logCounting || ddPackage == CUDD);
 
+    approximationTolerance = result[APPROXIMATION_OPTION].as<Float>(); // global var
+    assert(approximationTolerance >= 0);
+    assert(!approximationTolerance || logCounting);
+
     logBound = stold(result[LOG_BOUND_OPTION].as<string>()); // global var
     assert(logBound == -INF || !projectedCounting);
     assert(logBound == -INF || existRandom);
@@ -1378,6 +4108,21 @@ OptionDict::OptionDict(int argc, char** argv) {
     assert(!existPruning || logBound == -INF);
     assert(!existPruning || thresholdModel.empty());
 
+    upperBoundPruning = result[UPPER_BOUND_OPTION].as<Int>(); // global var
+    assert(!upperBoundPruning || existRandom);
+    assert(!upperBoundPruning || logCounting);
+
+    localSearchDuration = result[LOCAL_SEARCH_OPTION].as<Float>(); // global var
+    assert(localSearchDuration <= 0 || !projectedCounting);
+    assert(localSearchDuration <= 0 || existRandom);
+    assert(localSearchDuration <= 0 || logCounting);
+
+    boundUpdating = result[BOUND_UPDATING_OPTION].as<Int>(); // global var
+    boundUpdating = max(boundUpdating, 0ll);
+    assert(!boundUpdating || !projectedCounting);
+    assert(!boundUpdating || existRandom);
+    assert(!boundUpdating || logCounting);
+
     maximizerFormat = result[MAXIMIZER_FORMAT_OPTION].as<Int>(); // global var
     assert(MAXIMIZER_FORMATS.contains(maximizerFormat));
     assert(!maximizerFormat || existRandom);
@@ -1386,9 +4131,13 @@ OptionDict::OptionDict(int argc, char** argv) {
     maximizerVerification = result[MAXIMIZER_VERIFICATION_OPTION].as<Int>(); // global var
     assert(!maximizerVerification || maximizerFormat);
 
+    maximizerExtraction = result[MAXIMIZER_EXTRACTION_OPTION].as<Int>(); // global var
+    assert(MAXIMIZER_EXTRACTIONS.contains(maximizerExtraction));
+
     substitutionMaximization = result[SUBSTITUTION_MAXIMIZATION_OPTION].as<Int>(); // global var
     assert(!substitutionMaximization || !weightedCounting);
     assert(!substitutionMaximization || maximizerFormat);
+    assert(!substitutionMaximization || maximizerExtraction == DERIVATIVE_SIGNS);
 
     plannerWaitDuration = result[PLANNER_WAIT_OPTION].as<Float>();
     plannerWaitDuration = max(plannerWaitDuration, 0.0l);
@@ -1403,6 +4152,13 @@ OptionDict::OptionDict(int argc, char** argv) {
     threadSliceCount = max(threadSliceCount, 1ll);
     assert(threadSliceCount == 1 || ddPackage == CUDD);
 
+    workerProcessCount = result[WORKER_PROCESS_COUNT_OPTION].as<Int>(); // global var
+    workerProcessCount = max(workerProcessCount, 0ll);
+    assert(!workerProcessCount || ddPackage == CUDD);
+    assert(!workerProcessCount || threadCount == 1); // worker processes replace threads
+    assert(!workerProcessCount || !maximizerFormat || maximizerExtraction == TOP_DOWN); // maximization stack would be in worker processes
+    assert(!workerProcessCount || !approximationTolerance); // worker responses carry no error bound
+
     randomSeed = result[RANDOM_SEED_OPTION].as<Int>(); // global var
 
     ddVarOrderHeuristic = result[DD_VAR_OPTION].as<Int>();
@@ -1415,22 +4171,63 @@ OptionDict::OptionDict(int argc, char** argv) {
 
     maxMem = result[MAX_MEM_OPTION].as<Float>(); // global var
 
+    memoryGovernor = result[MEMORY_GOVERNOR_OPTION].as<Float>(); // global var
+    assert(memoryGovernor >= 0);
+
+    dynamicReordering = result[DYNAMIC_REORDERING_OPTION].as<Int>(); // global var
+    assert(DYNAMIC_REORDERINGS.contains(dynamicReordering));
+    assert(!dynamicReordering || ddPackage == CUDD); // Sylvan 1.5 has no dynamic reordering
+
+    reorderingThreshold = result[REORDERING_THRESHOLD_OPTION].as<Int>(); // global var
+    reorderingThreshold = max(reorderingThreshold, 1ll);
+
     tableRatio = result[TABLE_RATIO_OPTION].as<Int>();
 
     initRatio = result[INIT_RATIO_OPTION].as<Int>();
 
     multiplePrecision = result[MULTIPLE_PRECISION_OPTION].as<Int>(); // global var
     assert(!multiplePrecision || ddPackage == SYLVAN);
+    assert(compiledCnfPath.empty() || !multiplePrecision); // file has Float weights and terminals
 
     joinPriority = result[JOIN_PRIORITY_OPTION].as<string>(); //global var
     assert(JOIN_PRIORITIES.contains(joinPriority));
 
+    joinTreeOptimization = result[JOIN_TREE_OPTIMIZATION_OPTION].as<Int>(); // global var
+
+    joinTreeCacheDir = result[JOIN_TREE_CACHE_OPTION].as<string>(); // global var
+
+    xorElimination = result[XOR_ELIMINATION_OPTION].as<Int>(); // global var
+
+    preprocessing = result[PREPROCESSING_OPTION].as<Int>(); // global var
+
+    componentDecomposition = result[COMPONENT_DECOMPOSITION_OPTION].as<Int>(); // global var
+    assert(!componentDecomposition || ddPackage == CUDD);
+    assert(!componentDecomposition || !workerProcessCount);
+    assert(!componentDecomposition || !maximizerFormat || maximizerExtraction == TOP_DOWN); // threads would interleave maximization stack
+
+    checkpointJournalPath = result[CHECKPOINT_JOURNAL_OPTION].as<string>(); // global var
+    assert(checkpointJournalPath.empty() || ddPackage == CUDD);
+    assert(checkpointJournalPath.empty() || !maximizerFormat || maximizerExtraction == TOP_DOWN); // journaled slices leave no maximization stack
+    assert(checkpointJournalPath.empty() || !approximationTolerance); // journaled slices carry no error bound
+
+    assert(!memoryGovernor || !maximizerFormat || maximizerExtraction == TOP_DOWN); // re-sliced subtrees would leave partial maximization stack
+
+    assert(weightFilePath.empty() || ddPackage == CUDD);
+    assert(weightFilePath.empty() || (!maximizerFormat && logBound == -INF && thresholdModel.empty() && !existPruning && !upperBoundPruning && localSearchDuration <= 0 && !boundUpdating)); // maximizers and bounds would depend on weight vector
+    assert(weightFilePath.empty() || (!workerProcessCount && checkpointJournalPath.empty() && !componentDecomposition && !approximationTolerance)); // batch mode solves whole join tree per weight vector
+    assert(marginalFilePath.empty() || (!projectedCounting && !existRandom)); // outside DDs are sums over all vars
+    assert(marginalFilePath.empty() || (!maximizerFormat && logBound == -INF && thresholdModel.empty() && !existPruning && !upperBoundPruning && localSearchDuration <= 0 && !boundUpdating)); // pruning would bias outside DDs
+    assert(marginalFilePath.empty() || (!workerProcessCount && checkpointJournalPath.empty() && !componentDecomposition && !approximationTolerance && !multiplePrecision)); // marginal mode keeps DDs of whole join tree in one manager
+
     verboseCnf = result[VERBOSE_CNF_OPTION].as<Int>(); // global var
 
     verboseJoinTree = result[VERBOSE_JOIN_TREE_OPTION].as<Int>(); // global var
 
     verboseProfiling = result[VERBOSE_PROFILING_OPTION].as<Int>(); // global var
-    assert(verboseProfiling <= 0 || threadCount == 1);
+    assert(verboseProfiling <= 0 || !workerProcessCount);
+
+    profileFilePrefix = result[PROFILE_FILE_OPTION].as<string>(); // global var
+    assert(profileFilePrefix.empty() || !workerProcessCount); // records of worker processes would be lost
 
     verboseSolving = result[VERBOSE_SOLVING_OPTION].as<Int>(); // global var
 
@@ -1445,7 +4242,9 @@ OptionDict::OptionDict(int argc, char** argv) {
 
 /* global functions ========================================================= */
 
+#ifndef DMC_LIBRARY // defined when bench/dd links Dd and Executor without this entry point
 int main(int argc, char** argv) {
   cout << std::unitbuf; // enables automatic flushing
   OptionDict(argc, argv);
 }
+#endif
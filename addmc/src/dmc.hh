@@ -24,11 +24,19 @@ using sylvan::gmp_op_times_CALL;
 using sylvan::mtbdd_apply_CALL;
 using sylvan::mtbdd_fprintdot_nc;
 using sylvan::mtbdd_getdouble;
+using sylvan::mtbdd_gethigh;
+using sylvan::mtbdd_getlow;
 using sylvan::mtbdd_getvalue;
+using sylvan::mtbdd_getvar;
+using sylvan::mtbdd_isleaf;
 using sylvan::mtbdd_gmp;
 using sylvan::mtbdd_makenode;
 using sylvan::Mtbdd;
 using sylvan::MTBDD;
+using sylvan::sylvan_gc_CALL;
+using sylvan::sylvan_stats_snapshot_CALL;
+using sylvan::sylvan_stats_t;
+using sylvan::sylvan_table_usage_CALL;
 
 using CMSat::Lit;
 using CMSat::lbool; // generally uint8_t; typically {l_True, l_False, l_Undef}
@@ -40,27 +48,40 @@ using CMSat::l_False;
 const Float MEGA = 1e6l; // same as countAntom (1 MB = 1e6 B)
 
 const string WEIGHTED_COUNTING_OPTION = "wc";
+const string WEIGHT_FILE_OPTION = "wf";
+const string MARGINAL_FILE_OPTION = "mr";
 const string EXIST_RANDOM_OPTION = "er";
-const string LOG_COUNTING_OPTION = "lc";
+const string APPROXIMATION_OPTION = "ae";
 const string LOG_BOUND_OPTION = "lb";
 const string THRESHOLD_MODEL_OPTION = "tm";
 const string EXIST_PRUNING_OPTION = "ep";
+const string BOUND_UPDATING_OPTION = "bu";
+const string LOCAL_SEARCH_OPTION = "ls";
+const string UPPER_BOUND_OPTION = "up";
 const string MAXIMIZER_FORMAT_OPTION = "mf";
 const string MAXIMIZER_VERIFICATION_OPTION = "mv";
+const string MAXIMIZER_EXTRACTION_OPTION = "me";
 const string SUBSTITUTION_MAXIMIZATION_OPTION = "sm";
 const string PLANNER_WAIT_OPTION = "pw";
 const string THREAD_COUNT_OPTION = "tc";
 const string THREAD_SLICE_COUNT_OPTION = "ts";
+const string WORKER_PROCESS_COUNT_OPTION = "wp";
 const string DD_VAR_OPTION = "dv";
 const string SLICE_VAR_OPTION = "sv";
 const string MEM_SENSITIVITY_OPTION = "ms";
 const string MAX_MEM_OPTION = "mm";
+const string MEMORY_GOVERNOR_OPTION = "mg";
+const string DYNAMIC_REORDERING_OPTION = "dr";
+const string REORDERING_THRESHOLD_OPTION = "rt";
 const string TABLE_RATIO_OPTION = "tr";
 const string INIT_RATIO_OPTION = "ir";
 const string MULTIPLE_PRECISION_OPTION = "mp";
 const string JOIN_PRIORITY_OPTION = "jp";
+const string JOIN_TREE_OPTIMIZATION_OPTION = "jo";
+const string CHECKPOINT_JOURNAL_OPTION = "cj";
 const string VERBOSE_JOIN_TREE_OPTION = "vj";
 const string VERBOSE_PROFILING_OPTION = "vp";
+const string PROFILE_FILE_OPTION = "pf";
 
 /* maximizer formats: */
 const Int NONE = 0;
@@ -74,6 +95,23 @@ const map<Int, string> MAXIMIZER_FORMATS = {
   {ALL, "ALL"}
 };
 
+/* maximizer extractions: */
+const Int DERIVATIVE_SIGNS = 0; // keeps one derivative-sign DD per maximized var
+const Int TOP_DOWN = 1; // recomputes child DDs of join nodes after solving
+const map<Int, string> MAXIMIZER_EXTRACTIONS = {
+  {DERIVATIVE_SIGNS, "DERIVATIVE_SIGNS"},
+  {TOP_DOWN, "TOP_DOWN"}
+};
+
+/* dynamic reorderings: */
+const Int SIFT_REORDERING = 1;
+const Int WINDOW_REORDERING = 2;
+const map<Int, string> DYNAMIC_REORDERINGS = {
+  {NONE, "NONE"},
+  {SIFT_REORDERING, "SIFT"},
+  {WINDOW_REORDERING, "WINDOW"}
+};
+
 /* join priorities: */
 const string ARBITRARY_PAIR = "a";
 const string BIGGEST_PAIR = "b";
@@ -84,24 +122,60 @@ const map<string, string> JOIN_PRIORITIES = {
   {SMALLEST_PAIR, "SMALLEST_PAIR"}
 };
 
+/* join tree variants: */
+const string ORIGINAL_VARIANT = "ORIGINAL";
+const string BINARIZED_VARIANT = "BINARIZED";
+const string FLATTENED_VARIANT = "FLATTENED_BINARIZED";
+const string REROOTED_VARIANT = "REROOTED";
+
+const Int MAX_PAIRING_PARTNERS = 1 << 6; // binarization pairs all remaining children up to this many, else each new node with this many sharing vars and this many smallest
+const Int REROOTING_CANDIDATE_COUNT = 8;
+
+const Float LOCAL_SEARCH_NOISE = 0.5; // probability of random walk step in unsatisfied clause
+const Int LOCAL_SEARCH_CLOCK_PERIOD = 1 << 10; // flips between time checks
+
+const Int MAX_BOUNDING_CLAUSE_WIDTH = 16; // clause is enumerated when bounding slices
+const Float UPPER_BOUND_TOLERANCE = 1e-9; // absorbs rounding differences between slice bounds and slice solutions
+
+const Int MAX_SLICE_ATTEMPTS = 3; // per slice, before worker processes give up
+
+const Int WEIGHT_VECTOR_BATCH_SIZE = 1 << 10; // read before solving; solutions are printed per batch
+
+const string JOURNAL_HEADER_WORD = "journal";
+
 /* global vars ============================================================== */
 
+extern string weightFilePath; // empty: CNF weights only; else batch mode with one weight vector per line
+extern Int weightLaneCount; // weight vectors per pass over WeightlessDd
+extern string compiledCnfPath; // empty: no compiled CNF file for dmq
+extern string marginalFilePath; // empty: no marginals
 extern bool existRandom;
 extern string ddPackage;
-extern bool logCounting;
+extern Float approximationTolerance; // 0: exact; else terminals within this relative tolerance are merged at join nodes
 extern Float logBound;
 extern string thresholdModel;
 extern bool existPruning;
+extern Float localSearchDuration; // in seconds; 0: no local search
+extern bool upperBoundPruning; // skips slices whose relaxed bound is below best finished slice or logBound
+extern Int boundUpdating; // SAT models for initial bound, then completed slices raise logBound; 0: logBound is fixed
 extern Int maximizerFormat;
 extern bool maximizerVerification;
+extern Int maximizerExtraction;
 extern bool substitutionMaximization;
 extern Int threadCount;
 extern Int threadSliceCount; // may be lower or higher than actual number of slices per thread
+extern Int workerProcessCount; // 0: slices are solved by threads instead
 extern Float memSensitivity; // in MB (1e6 B)
 extern Float maxMem; // in MB (1e6 B)
+extern Float memoryGovernor; // 0: CUDD aborts when out of mem; else fraction of mem share at which subtrees are re-sliced
+extern Int dynamicReordering;
+extern Int reorderingThreshold; // live nodes in CUDD manager before first reordering
 extern string joinPriority;
+extern bool joinTreeOptimization;
+extern string checkpointJournalPath; // empty: no checkpointing
 extern Int verboseJoinTree; // 1: parsed join tree, 2: raw join tree too
 extern Int verboseProfiling; // 1: sorted stats for CNF vars, 2: unsorted stats for join nodes too
+extern string profileFilePrefix; // empty: no profile; else {prefix}.json (Chrome trace events), {prefix}.csv, and {prefix}.vars.csv
 
 extern Int dotFileIndex;
 
@@ -115,6 +189,7 @@ public:
 
   Map<Int, JoinTerminal*> joinTerminals; // 0-indexing
   Map<Int, JoinNonterminal*> joinNonterminals; // 0-indexing
+  Set<Int> projectedVars; // by nonterminals so far, each var at most once
 
   Int width = MIN_INT; // width of latest join tree
   Float plannerDuration = 0; // cumulative time for all join trees, in seconds
@@ -147,16 +222,61 @@ public:
 
   const JoinNonterminal* getJoinTreeRoot() const;
 
+  void startJoinTree(Int declaredVarCount, Int declaredClauseCount, Int declaredNodeCount);
+  void addNonterminal(
+    Int parentIndex, // 0-indexing
+    const vector<Int>& childIndices, // 0-indexing
+    const Set<Int>& projectionVars
+  );
+
   void processCommentLine(const vector<string>& words);
   void processProblemLine(const vector<string>& words);
   void processNonterminalLine(const vector<string>& words);
+  void processBinaryFrame(istream& inputStream, const vector<string>& words); // "b <byte count>" line then payload
 
   void finishReadingJoinTree();
-  void readInputStream();
+  void readInputStream(istream& inputStream);
+  void readCachedJoinTree(const JoinTreeCache& joinTreeCache); // before stdin
 
   JoinTreeProcessor(Float plannerWaitDuration);
 };
 
+class JoinTreeDraft { // mutable copy of join tree for optimization before execution
+public:
+  vector<JoinNode*> terminals; // draft index |-> JoinTerminal, or nullptr for nonterminal
+  vector<vector<Int>> children; // draft indices
+  vector<Set<Int>> projectionVars;
+  vector<Set<Int>> preProjectionVars;
+  Int root = MIN_INT;
+
+  static bool isOuterVar(Int var);
+  static bool haveSameQuantifier(const Set<Int>& vars1, const Set<Int>& vars2); // so projections commute
+
+  Int addNode(JoinNode* terminal, const vector<Int>& childIndices, const Set<Int>& projections);
+  Int importSubtree(const JoinNode* joinNode);
+  bool isTerminal(Int index) const;
+  Set<Int> getPostProjectionVars(Int index) const;
+  vector<Int> getPostOrder() const; // reachable from root
+  Int getWidth() const;
+  Float getCost() const; // sum over nonterminals of (applications + abstractions) * 2^|preProjectionVars|
+
+  void flatten(); // splices projection-free nonterminals into parents
+  void binarize(Int parent); // greedily pairs children with smallest post-projection var union, via heap of candidate pairs
+  void binarize();
+  void pushProjectionsDown(); // moves each projection var to lowest possible node, respecting quantifier order
+  Int getContractedNode(Int index); // merges single-child chains
+  void mergeChains();
+  JoinTreeDraft getRerootedDraft(Int newRoot) const; // places projections at LCAs; requires one quantifier for all vars
+  vector<Int> getRerootingCandidates() const;
+
+  JoinNonterminal* getJoinRoot() const; // constructs new nonterminals, reusing terminals
+
+  static const JoinNonterminal* getOptimizedJoinRoot(const JoinNonterminal* joinRoot); // prints variants and returns cheapest
+
+  JoinTreeDraft(const JoinNonterminal* joinRoot);
+  JoinTreeDraft();
+};
+
 /* classes for execution ==================================================== */
 
 class SatSolver {
@@ -169,12 +289,36 @@ public:
   SatSolver(const Cnf& cnf);
 };
 
+class LocalSearcher { // WalkSAT-style search for models of XOR-CNF with high product of literal weights
+public:
+  const Cnf& cnf;
+  std::mt19937_64 generator;
+  vector<Float> positiveLogWeights; // var |-> log10 weight (1-indexing)
+  vector<Float> negativeLogWeights;
+  vector<bool> vals; // var |-> value (1-indexing)
+  Float logWeight = 0; // of current assignment
+  vector<Int> trueLiteralCounts; // clause index |-> count
+  vector<Int> unsatClauseIndices;
+  vector<Int> unsatPositions; // clause index |-> position in unsatClauseIndices, or -1 if satisfied
+
+  bool isSatisfied(Int clauseIndex) const; // by trueLiteralCounts (odd count for XOR clause)
+  Float getLogWeightGain(Int var) const;
+  Int getBreakCount(Int var) const; // satisfied clauses that flipping var would falsify
+  void flipVar(Int var);
+  Int pickVarInUnsatClause();
+  Int pickWeightGainingVar(); // MIN_INT if random samples gain nothing
+  void search(Float duration, Assignment& bestModel, Float& bestLogWeight, mutex& bestMutex); // shares best model across threads
+
+  LocalSearcher(const Cnf& cnf, Int seed); // starts from heavier literal of each var
+};
+
 class Dd { // wrapper for CUDD and Sylvan
 public:
   static Float pruningDuration;
 
   ADD cuadd; // CUDD
   Mtbdd mtbdd; // Sylvan
+  Float logErrorBound = 0; // max |log10 error| of terminals due to rounding; products add bounds, sums and maxes take max
 
   Dd(const ADD& cuadd);
   Dd(const Mtbdd& mtbdd);
@@ -185,6 +329,9 @@ public:
   static Dd getZeroDd(const Cudd* mgr); // returns minus infinity if logCounting
   static Dd getOneDd(const Cudd* mgr); // returns zero if logCounting
   static Dd getVarDd(Int ddVar, bool val, const Cudd* mgr);
+  static Int getVarLevel(Int ddVar, const Cudd* mgr); // creates CUDD var if absent
+  static Dd getNodeDd(Int ddVar, const Dd& highDd, const Dd& lowDd, const Cudd* mgr); // ddVar must be above vars of both children
+  static Dd getClauseDd(const vector<pair<Int, bool>>& ddLiterals, bool xorFlag, bool parityFlag, const Cudd* mgr); // ddLiterals are (DD var, val) from bottom level up
   static const Cudd* newMgr(Float mem, Int threadIndex = 0); // CUDD
   size_t getNodeCount() const;
   bool operator!=(const Dd& rightDd) const;
@@ -197,6 +344,7 @@ public:
   Set<Int> getSupport() const;
   Dd getBoolDiff(const Dd& rightDd) const; // returns 0-1 DD for *this >= rightDd
   bool evalAssignment(vector<int>& ddVarAssignment) const;
+  vector<int> getMaxCube(const Cudd* mgr) const; // DD var |-> 0, 1, or 2 (either) for some max terminal
   Dd getAbstraction(
     Int ddVar,
     const vector<Int>& ddVarToCnfVarMap,
@@ -206,32 +354,206 @@ public:
     vector<pair<Int, Dd>>& maximizationStack,
     const Cudd* mgr
   ) const;
+  Dd getSumAbstraction(const vector<Int>& ddVars, const Cudd* mgr) const; // sums out ddVars in one pass; weights must be multiplied in first
   Dd getPrunedDd(Float lowerBound, const Cudd* mgr) const;
+  Dd getRoundedDd(Float logStep, const Cudd* mgr) const; // rounds log10 terminals to multiples of logStep
+  WeightlessDd getFlattenedDd(Int ddVarCount, const Cudd* mgr) const; // levels are CUDD var order or Sylvan DD vars
   void writeDotFile(const Cudd* mgr, string dotFileDir = "./") const;
   static void writeInfoFile(const Cudd* mgr, string filePath);
 };
 
+class SliceJournal { // completed slices, appended to file so that interrupted sliced execution can resume
+public:
+  string filePath;
+  string runKey; // hash key of CNF, weights, options, join tree, and slice assignments
+  Map<string, Float> finishedSlices; // assignment key |-> partial solution
+  std::ofstream journalStream;
+
+  static string getAssignmentKey(const Assignment& assignment); // sorted literals
+  static string getRunKey(const JoinNonterminal* joinRoot, const vector<Assignment>& assignments);
+
+  bool getFinishedSlice(const Assignment& assignment, Number& partialSolution) const;
+  void addFinishedSlice(const Assignment& assignment, const Number& partialSolution); // line "{literals} 0 {hexfloat solution}"
+
+  SliceJournal(string filePath, const JoinNonterminal* joinRoot, const vector<Assignment>& assignments); // keeps entries only if run key matches
+};
+
+class SliceWorker { // child process solving slices sent by coordinator
+public:
+  pid_t pid = -1;
+  FILE* requestFile = nullptr; // coordinator writes "{slice index} {hexfloat log bound} {literal count} {literals}"
+  FILE* responseFile = nullptr; // worker writes "{slice index} {hexfloat solution}"
+  Int sliceIndex = MIN_INT; // slice in progress, or MIN_INT if idle
+  TimePoint sliceStartPoint;
+
+  bool isIdle() const;
+  void sendSlice(Int index, const Assignment& assignment); // may leave worker dead
+  void stop(bool killingFlag = false); // closes pipes and reaps process, terminating it first if killingFlag (e.g., after malformed response)
+
+  static void runWorker( // never returns
+    const JoinNonterminal* joinRoot,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap,
+    Int workerIndex,
+    FILE* requestFile,
+    FILE* responseFile
+  );
+  static SliceWorker forkWorker(
+    const JoinNonterminal* joinRoot,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap,
+    Int workerIndex,
+    const vector<SliceWorker>& workers // pipes of other workers are closed in child
+  );
+};
+
+class DdCounters { // cumulative counters of one DD manager; deltas are attributed to join nodes and vars
+public:
+  Float cacheLookups = 0;
+  Float cacheHits = 0;
+  Int garbageCollections = 0;
+  Int reorderings = 0;
+  Int nodeGrowth = 0; // CUDD: live unique-table keys; Sylvan: created nodes
+
+  static DdCounters getSnapshot(const Cudd* mgr); // Sylvan counters stay 0 unless Sylvan is built with SYLVAN_STATS
+  DdCounters operator-(const DdCounters& counters) const;
+  DdCounters& operator+=(const DdCounters& counters);
+  string getJson() const;
+  string getCsv() const;
+};
+
+class ProfileRecord { // one evaluated join node
+public:
+  Int nodeIndex = MIN_INT;
+  bool terminalFlag = false;
+  Int threadIndex = 0;
+  Int sliceIndex = -1; // slice or component; -1 if unsliced
+  Int startMicroseconds = 0; // since toolStartPoint
+  Int durationMicroseconds = 0; // excludes children
+  vector<size_t> inputSizes; // child DDs
+  size_t outputSize = 0;
+  vector<Int> projectionVars; // sorted CNF vars
+  DdCounters joinCounters; // clause DD construction for terminal; products and reordering for nonterminal
+  vector<pair<Int, DdCounters>> projectionCounters; // (CNF var, abstraction and pruning) in projection order
+};
+
+class Profiler { // each thread appends to its own buffer without locking; buffers are merged after threads join
+public:
+  static mutex bufferMutex; // for registering buffers only
+  static vector<std::unique_ptr<vector<ProfileRecord>>> buffers; // outlive their threads
+  static thread_local vector<ProfileRecord>* threadBuffer; // nullptr until first record in thread
+  static thread_local Int threadSliceIndex; // set by slice and component loops
+
+  static Int getMicroseconds(TimePoint timePoint); // since toolStartPoint
+  static DdCounters getCounters(const Cudd* mgr); // zeros if profileFilePrefix is empty
+  static void addRecord( // no-op if profileFilePrefix is empty
+    const JoinNode* joinNode,
+    const Cudd* mgr,
+    TimePoint startPoint,
+    const vector<size_t>& inputSizes,
+    const Dd& dd,
+    const DdCounters& joinCounters,
+    const vector<pair<Int, DdCounters>>& projectionCounters
+  );
+  static vector<ProfileRecord> getMergedRecords(); // sorted by start time
+  static void writeTraceFile(const vector<ProfileRecord>& records, string filePath); // Chrome trace-event JSON for Perfetto
+  static void writeCsvFile(const vector<ProfileRecord>& records, string filePath);
+  static void writeVarCsvFile(const vector<ProfileRecord>& records, string filePath); // counters summed per projected var
+  static void writeFiles();
+};
+
+class MemoryExhaustionException : public std::exception {}; // caught by Executor::solveSubtree, which re-slices, or turned into MyError at join root
+class ReslicingExhaustionException : public MemoryExhaustionException {}; // slices of re-sliced join node still exhaust mem, so ancestors do not re-slice
+
+class MemoryGovernor { // escalates near mem share: garbage collection, then capped table growth, then re-slicing
+public:
+  DdManager* manager;
+  size_t memLimit; // in bytes
+  bool growthCapped = false;
+  bool exhaustedFlag = false; // over memLimit without garbage to collect
+
+  static mutex governorMutex; // for registering governors only
+  static vector<std::unique_ptr<MemoryGovernor>> governors; // one per CUDD manager
+  static std::atomic<size_t> liveNodeCount; // Sylvan: after last garbage collection
+  static std::atomic<size_t> tableSize; // Sylvan: node table, after last garbage collection
+  static std::atomic<Int> collectionCount; // forced by governor
+  static std::atomic<Int> growthCapCount;
+  static std::atomic<Int> exhaustionCount;
+  static std::atomic<Int> reslicedSubtreeCount;
+
+  static size_t getMaxCacheSlots(Float mem); // cache table gets quarter of governed mem share
+  size_t getLiveMem() const; // live nodes and cache table, unlike memused, which never decreases
+  static void govern(const Cudd* mgr, Float mem); // CUDD: registers termination callback and handler
+  static void ungovern(const Cudd* mgr); // CUDD: before manager is deleted
+  static int checkMem(const void* governor); // CUDD termination callback, consulted by cuddAllocNode and polled by cuddUniqueInter
+  static void throwExhaustion(string); // CUDD termination handler, whose PFC type requires message parameter
+  static void updateTableFill(WorkerP* worker, Task* task); // Sylvan post-GC hook
+  static void checkTableFill(); // Sylvan: forces garbage collection above memoryGovernor, then throws if still above
+};
+
 class Executor {
 public:
   static vector<pair<Int, Dd>> maximizationStack; // pair<DD var, derivative sign>
 
   static Int prunedDdCount;
+  static mutex logBoundMutex; // logBound may be raised while threads prune
+
+  static Float readLogBound();
+  static void raiseLogBound(Float newLogBound); // monotone
+
+  static Int skippedSliceCount; // by upperBoundPruning
+
+  static Float logErrorBound; // of solution, if approximationTolerance
+
+  static thread_local const Map<Int, Number>* threadLiteralWeights; // batch mode: weight vector being solved; nullptr: CNF weights
+  static const Map<Int, Number>& getLiteralWeights();
+  static std::atomic<Int> roundedDdCount; // changed by rounding
+
+  static thread_local bool governedSolvingFlag; // inside outermost solveSubtree call of thread, if memoryGovernor
+  static thread_local Set<string> splitSubtreeKeys; // join node and assignment to its subtree vars, re-sliced in current solve
+
+  static Map<const Cudd*, Map<string, Dd>> clauseDdCaches; // DD manager |-> restricted clause key |-> clause DD
+  static mutex clauseDdCacheMutex; // for outer map only, as each manager is used by one thread
+  static std::atomic<Int> clauseDdCount; // built
+  static std::atomic<Int> clauseDdCacheHitCount;
+
+  static mutex reorderingMutex; // for stats below
+  static Int reorderingCount;
+  static Float reorderingDuration; // in seconds
+  static Int preReorderingNodeCount; // sum over reorderings
+  static Int postReorderingNodeCount; // sum over reorderings
+  static std::atomic<size_t> peakDdSize; // updated if joinTreeOptimization
+  static SliceJournal* sliceJournal; // nullptr if checkpointJournalPath is empty
 
   static Map<Int, Float> varDurations; // CNF var |-> total execution time in seconds
   static Map<Int, size_t> varDdSizes; // CNF var |-> max DD size
+  static mutex varStatsMutex; // for varDurations and varDdSizes
 
   static void updateVarDurations(const JoinNode* joinNode, TimePoint startPoint);
   static void updateVarDdSizes(const JoinNode* joinNode, const Dd& dd);
+  static void updatePeakDdSize(const Dd& dd);
+  static void reorderDdVars(const Cudd* mgr); // at join-node boundaries, if live nodes reach next reordering
 
   static void printVarDurations();
   static void printVarDdSizes();
 
+  static void releaseMem(const Cudd* mgr); // after MemoryExhaustionException: clears error code and clause-DD cache, then collects garbage
+  static void deleteMgr(const Cudd* mgr); // CUDD: after its other DDs are destroyed; drops clause-DD cache and governor first
+
   static Dd getClauseDd(
     const Map<Int, Int>& cnfVarToDdVarMap,
     const Clause& clause,
     const Cudd* mgr,
     const Assignment& assignment
   );
+  static Dd getProjectedDd( // prunes if logBound is set
+    const Dd& dd,
+    Int cnfVar,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap,
+    const Cudd* mgr,
+    const Assignment& assignment
+  );
   static Dd solveSubtree( // recursively computes valuation of project-join tree node
     const JoinNode* joinNode,
     const Map<Int, Int>& cnfVarToDdVarMap,
@@ -239,6 +561,65 @@ public:
     const Cudd* mgr = nullptr,
     const Assignment& assignment = Assignment()
   );
+  static Dd solveNonterminal( // solves children, then joins and projects
+    const JoinNonterminal* joinNode,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap,
+    const Cudd* mgr,
+    const Assignment& assignment
+  );
+  static Dd solveReslicedSubtree( // sequentially solves both slices on biggest-node unassigned outer var; throws if none or if already split
+    const JoinNonterminal* joinNode,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap,
+    const Cudd* mgr,
+    const Assignment& assignment
+  );
+  static Dd getWeightlessDd( // product of clause DDs in subtree; throws MemoryExhaustionException above memLimit
+    const JoinNode* joinNode,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const Cudd* mgr,
+    size_t memLimit // in bytes
+  );
+  static vector<Int> getWeightlessProjectionOrder(const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr); // CNF vars; inner vars first, each block from bottom level up
+  static void writeCompiledCnf( // before solving, so that dmq can query without recompiling
+    const JoinNonterminal* joinRoot,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap
+  );
+  static Dd solveInsideDds( // upward pass of marginal mode: keeps joined DD (before projection) and output DD of each node
+    const JoinNode* joinNode,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap,
+    const Cudd* mgr,
+    Map<const JoinNode*, Dd>& joinedDds,
+    Map<const JoinNode*, Dd>& outputDds
+  );
+  static void addOutsideDds( // downward pass: flattens product of joined DD and outside DD of each nonterminal, then sends outside DDs to children
+    const JoinNonterminal* joinNode,
+    const Dd& outsideDd, // over post-projection vars of joinNode, whose weights are not applied yet
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap,
+    const Cudd* mgr,
+    const Map<const JoinNode*, Dd>& joinedDds,
+    const Map<const JoinNode*, Dd>& outputDds,
+    vector<pair<const JoinNonterminal*, WeightlessDd>>& flatDds
+  );
+  static Number solveMarginals( // writes CSV of weighted counts with each var true and false; returns apparent solution
+    const JoinNonterminal* joinRoot,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap
+  );
+  static void solveWeightVectors( // batch mode: each thread compiles weightless DD once if it fits, then only projects per weight vector
+    const JoinNonterminal* joinRoot,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap
+  );
+  static Float getBlockLogUpperBound(const Clause& clause, const Assignment& assignment); // exact for clause alone
+  static Float getSliceLogUpperBound(const Assignment& assignment); // relaxes CNF to greedily chosen var-disjoint clauses
+  static void sortSlicesByUpperBound(vector<Assignment>& assignments); // best-first, so that incumbent rises early
+  static bool isSliceDominated(const Assignment& assignment, const Number& totalSolution); // cannot improve max over slices
+  static void addPartialSolution(Number& totalSolution, const Number& partialSolution); // max if existRandom, else (log-)sum
   static void solveThreadSlices( // sequentially solves all slices in one thread
     const JoinNonterminal* joinRoot,
     const Map<Int, Int>& cnfVarToDdVarMap,
@@ -253,6 +634,17 @@ public:
     const JoinNonterminal* joinRoot,
     Int sliceVarOrderHeuristic
   );
+  static Number solveWorkerSlices( // coordinator hands slices to worker processes and retries failed slices
+    const JoinNonterminal* joinRoot,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap,
+    Int sliceVarOrderHeuristic
+  );
+  static Number solveComponents( // solves groups of root children with disjoint components in parallel and multiplies solutions
+    const JoinNonterminal* joinRoot,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap
+  );
   static Number solveCnf(
     const JoinNonterminal* joinRoot,
     const Map<Int, Int>& cnfVarToDdVarMap,
@@ -260,6 +652,7 @@ public:
     Int sliceVarOrderHeuristic
   );
 
+  static Assignment searchLocally(const Cnf& cnf); // runs threadCount LocalSearcher threads for localSearchDuration
   static void setLogBound(
     const JoinNonterminal* joinRoot,
     const Map<Int, Int>& cnfVarToDdVarMap,
@@ -271,7 +664,7 @@ public:
 
   static void printSatRow(const Number& solution, bool unsatFlag, size_t keyWidth); // "s {satisfiability}"
   static void printTypeRow(size_t keyWidth); // "c s type {track}"
-  static void printEstRow(const Number& solution, size_t keyWidth); // "c s log10-estimate {log(sol)}"
+  static void printEstRow(const Number& solution, size_t keyWidth); // "c s log10-estimate {log(sol)}", then "c s log10-error-bound {bound}" if approximationTolerance
   static void printArbRow(const Number& solution, bool frac, size_t keyWidth); // "c s exact arb {notation} {sol}"
   static void printDoubleRow(const Number& solution, size_t keyWidth); // "c s exact double prec-sci {sol}"
   static Number printAdjustedSolutionRows(const Number& solution, bool unsatFlag = false, size_t keyWidth = 0); // returns adjusted solution
@@ -280,7 +673,20 @@ public:
   static string getLongModel(const Assignment& model, Int declaredVarCount);
   static void printShortMaximizer(const Assignment& maximizer, Int declaredVarCount);
   static void printLongMaximizer(const Assignment& maximizer, Int declaredVarCount);
-  static Assignment printMaximizerRows(const vector<Int>& ddVarToCnfVarMap, Int declaredVarCount); // returns maximizer
+  static Assignment getStackMaximizer(const vector<Int>& ddVarToCnfVarMap); // pops maximizationStack
+  static void extractSubtreeMaximizer( // fixes maximized vars of joinNode given those of ancestors, then recurses on children
+    const JoinNode* joinNode,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap,
+    const Cudd* mgr,
+    Assignment& maximizer
+  );
+  static Assignment getTopDownMaximizer(
+    const JoinNonterminal* joinRoot,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap
+  );
+  static void printMaximizerRows(const Assignment& maximizer, Int declaredVarCount);
   static Number verifyMaximizer( // returns solution of residual formula
     const JoinNonterminal* joinRoot,
     const Map<Int, Int>& cnfVarToDdVarMap,
@@ -301,6 +707,8 @@ public:
   Int initRatio; // log2(max_size / init_size)
 
   static string helpMaximizerFormat();
+  static string helpMaximizerExtraction();
+  static string helpDynamicReordering();
   static string helpDdPackage();
   static string helpJoinPriority();
 
@@ -0,0 +1,206 @@
+#include "dmq.hh"
+
+/* classes for querying ===================================================== */
+
+/* class Querier ============================================================ */
+
+Number Querier::getLiteralWeight(Int literal) const {
+  auto it = weightUpdates.find(literal);
+  if (it != weightUpdates.end()) {
+    return it->second;
+  }
+  return compiledCnf.cnf.originalLiteralWeights.at(literal);
+}
+
+Assignment Querier::getEvidence(const vector<string>& words, Int lineIndex) const {
+  if (words.size() < 2 || words.back() != "0") {
+    throw MyError("query should be query word and literals ending with '0' | line ", lineIndex);
+  }
+  Assignment evidence;
+  for (Int i = 1; i + 1 < words.size(); i++) {
+    Int literal = stoll(words.at(i));
+    Int var = abs(literal);
+    if (literal == 0 || var > compiledCnf.cnf.declaredVarCount) {
+      throw MyError("literal '", literal, "' inconsistent with declared var count '", compiledCnf.cnf.declaredVarCount, "' | line ", lineIndex);
+    }
+    if (evidence.contains(var) && evidence.at(var) != (literal > 0)) {
+      throw MyError("complementary literals in evidence | line ", lineIndex);
+    }
+    evidence[var] = literal > 0;
+  }
+  return evidence;
+}
+
+Map<Int, Number> Querier::getConditionedWeights(const Assignment& evidence) const {
+  Map<Int, Number> updates = weightUpdates;
+  for (const auto& [var, val] : evidence) {
+    Int literal = val ? var : -var;
+    updates[literal] = getLiteralWeight(literal);
+    updates[-literal] = Number();
+  }
+  return compiledCnf.cnf.getFoldedLiteralWeights(updates);
+}
+
+Float Querier::getProbability(const Number& numerator, const Number& denominator) const {
+  return logCounting ? exp10l(numerator.fraction - denominator.fraction) : numerator.fraction / denominator.fraction;
+}
+
+void Querier::setWeights(const vector<string>& words, Int lineIndex) {
+  weightUpdates = compiledCnf.cnf.getWeightUpdates(vector<string>(words.begin() + 1, words.end()), lineIndex);
+  for (auto [literal, weight] : Map<Int, Number>(weightUpdates)) {
+    if (!weightUpdates.contains(-literal)) { // like Cnf::getFoldedLiteralWeights
+      if (weight >= Number("1")) {
+        throw MyError("weight of literal '", literal, "' must be below 1 without weight of literal '", -literal, "' | line ", lineIndex);
+      }
+      weightUpdates[-literal] = Number("1") - weight;
+    }
+  }
+}
+
+void Querier::answerCount(const Assignment& evidence, bool maximizationFlag) {
+  Map<Int, Number> literalWeights = getConditionedWeights(evidence);
+  Number solution = compiledCnf.getSolutions({&literalWeights}, maximizationFlag).front();
+  util::printRow("s query " + to_string(queryCount) + " log10-estimate", logCounting ? solution.fraction : solution.getLog10(), 0);
+}
+
+void Querier::answerMarginals(const Assignment& evidence) {
+  Map<Int, Number> evidenceWeights = getConditionedWeights(evidence);
+  Number evidenceSolution = compiledCnf.getSolutions({&evidenceWeights}, false).front();
+  util::printRow("s query " + to_string(queryCount) + " log10-estimate", logCounting ? evidenceSolution.fraction : evidenceSolution.getLog10(), 0);
+  if (evidenceSolution == Number(logCounting ? -INF : 0)) {
+    cout << WARNING << "evidence has zero weight; no marginals for query " << queryCount << "\n";
+    return;
+  }
+
+  vector<Int> vars; // outer vars outside evidence
+  for (Int var : util::getSortedNums(compiledCnf.cnf.outerVars)) {
+    if (!evidence.contains(var)) {
+      vars.push_back(var);
+    }
+  }
+  for (Int i = 0; i < vars.size(); i += laneCount) { // one pass per lane group
+    vector<Map<Int, Number>> laneWeights;
+    for (Int j = i; j < min(i + laneCount, static_cast<Int>(vars.size())); j++) {
+      Assignment extendedEvidence = evidence;
+      extendedEvidence[vars.at(j)] = true;
+      laneWeights.push_back(getConditionedWeights(extendedEvidence));
+    }
+    vector<const Map<Int, Number>*> laneLiteralWeights;
+    for (const Map<Int, Number>& literalWeights : laneWeights) {
+      laneLiteralWeights.push_back(&literalWeights);
+    }
+    vector<Number> solutions = compiledCnf.getSolutions(laneLiteralWeights, false);
+    for (Int lane = 0; lane < solutions.size(); lane++) {
+      util::printRow("s query " + to_string(queryCount) + " marginal " + to_string(vars.at(i + lane)), getProbability(solutions.at(lane), evidenceSolution), 0);
+    }
+  }
+}
+
+void Querier::answerQueries(istream& inputStream) {
+  TimePoint queryStartPoint = util::getTimePoint();
+  Int lineIndex = 0;
+  string line;
+  while (getline(inputStream, line)) {
+    lineIndex++;
+    vector<string> words = util::splitInputLine(line);
+    if (words.empty() || words.front() == "c") { // comment
+      continue;
+    }
+    const string& queryWord = words.front();
+    if (queryWord == WEIGHT_WORD) {
+      setWeights(words, lineIndex);
+      continue;
+    }
+    Assignment evidence = getEvidence(words, lineIndex);
+    queryCount++;
+    if (queryWord == COUNT_WORD) {
+      answerCount(evidence, false);
+    }
+    else if (queryWord == MAX_WORD) {
+      answerCount(evidence, true);
+    }
+    else if (queryWord == MARGINAL_WORD) {
+      answerMarginals(evidence);
+    }
+    else {
+      throw MyError("unknown query word '", queryWord, "' | line ", lineIndex);
+    }
+  }
+  util::printRow("queryCount", queryCount);
+  util::printRow("querySeconds", util::getDuration(queryStartPoint));
+}
+
+Querier::Querier(string compiledCnfPath, Int laneCount) : compiledCnf(compiledCnfPath), laneCount(laneCount) {
+  util::printRow("declaredVarCount", compiledCnf.cnf.declaredVarCount);
+  util::printRow("diagramVarCount", compiledCnf.ddVarToCnfVarMap.size());
+  util::printRow("compiledDiagramSize", compiledCnf.dd.nodeLevels.size());
+  util::printRow("loadingSeconds", util::getDuration(toolStartPoint));
+}
+
+/* class OptionDict ========================================================= */
+
+void OptionDict::runCommand() const {
+  if (verboseSolving >= 1) {
+    cout << "c processing command-line options...\n";
+    util::printRow("compiledCnfFile", compiledCnfPath);
+    util::printRow("queryFile", queryFilePath.empty() ? "stdin" : queryFilePath);
+    util::printRow("logCounting", logCounting);
+    util::printRow("weightLaneCount", laneCount);
+    cout << "\n";
+  }
+
+  Querier querier(compiledCnfPath, laneCount);
+  if (queryFilePath.empty()) {
+    cout << "c getting queries from stdin (end input with 'enter' then 'ctrl d')\n";
+    querier.answerQueries(std::cin);
+  }
+  else {
+    std::ifstream inputFileStream(queryFilePath);
+    if (!inputFileStream.is_open()) {
+      throw MyError("unable to open file '", queryFilePath, "'");
+    }
+    querier.answerQueries(inputFileStream);
+  }
+}
+
+OptionDict::OptionDict(int argc, char** argv) {
+  cxxopts::Options options("dmq", "Diagram Model Querier (reads compiled CNF from dmc)");
+  options.set_width(105);
+  options.add_options()
+    (COMPILED_CNF_OPTION, "compiled CNF file path, written by dmc; string (REQUIRED)", value<string>())
+    (QUERY_FILE_OPTION, "query file path (lines 'w {literal} {weight} ... 0', 'count {literals} 0', 'max {literals} 0', 'marginal {literals} 0'), or empty for stdin; string", value<string>()->default_value(""))
+    (LOG_COUNTING_OPTION, "logarithmic counting: 0, 1; int", value<Int>()->default_value("0"))
+    (WEIGHT_LANE_OPTION, "weight vectors evaluated per pass over weightless diagram (for marginals); int", value<Int>()->default_value("8"))
+    (VERBOSE_SOLVING_OPTION, util::helpVerboseSolving(), value<Int>()->default_value("1"))
+  ;
+  cxxopts::ParseResult result = options.parse(argc, argv);
+  if (result.count(COMPILED_CNF_OPTION)) {
+    cout << "c dmq process:\n";
+    cout << "c pid " << getpid() << "\n\n";
+
+    compiledCnfPath = result[COMPILED_CNF_OPTION].as<string>();
+
+    queryFilePath = result[QUERY_FILE_OPTION].as<string>();
+
+    logCounting = result[LOG_COUNTING_OPTION].as<Int>(); // global var
+
+    laneCount = result[WEIGHT_LANE_OPTION].as<Int>();
+    assert(laneCount > 0);
+
+    verboseSolving = result[VERBOSE_SOLVING_OPTION].as<Int>(); // global var
+
+    toolStartPoint = util::getTimePoint(); // global var
+    runCommand();
+    util::printRow("seconds", util::getDuration(toolStartPoint));
+  }
+  else {
+    cout << options.help();
+  }
+}
+
+/* global functions ========================================================= */
+
+int main(int argc, char** argv) {
+  cout << std::unitbuf; // enables automatic flushing
+  OptionDict(argc, argv);
+}
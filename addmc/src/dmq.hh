@@ -0,0 +1,58 @@
+#pragma once
+
+/* inclusions =============================================================== */
+
+#include "../libraries/cxxopts/include/cxxopts.hpp"
+
+#include "common.hh"
+
+/* uses ===================================================================== */
+
+using cxxopts::value;
+
+/* consts =================================================================== */
+
+const string QUERY_FILE_OPTION = "qf";
+
+/* query words: */
+const string WEIGHT_WORD = "w";
+const string COUNT_WORD = "count";
+const string MAX_WORD = "max";
+const string MARGINAL_WORD = "marginal";
+
+/* classes for querying ===================================================== */
+
+class Querier { // answers queries against compiled CNF without recompiling
+public:
+  const CompiledCnf compiledCnf;
+  const Int laneCount; // weight vectors per pass over weightless diagram
+  Map<Int, Number> weightUpdates; // from latest weight line, with both literals of each var
+  Int queryCount = 0;
+
+  Number getLiteralWeight(Int literal) const; // before preprocessing
+  Assignment getEvidence(const vector<string>& words, Int lineIndex) const; // "{literals} 0" after query word
+  Map<Int, Number> getConditionedWeights(const Assignment& evidence) const; // folded; falsified literals have weight 0
+  Float getProbability(const Number& numerator, const Number& denominator) const; // reads logCounting
+
+  void setWeights(const vector<string>& words, Int lineIndex); // "w {literal} {weight} ... 0"
+  void answerCount(const Assignment& evidence, bool maximizationFlag);
+  void answerMarginals(const Assignment& evidence); // of outer vars outside evidence
+  void answerQueries(istream& inputStream);
+
+  Querier(string compiledCnfPath, Int laneCount);
+};
+
+class OptionDict {
+public:
+  string compiledCnfPath;
+  string queryFilePath; // empty: stdin
+  Int laneCount;
+
+  void runCommand() const;
+
+  OptionDict(int argc, char** argv);
+};
+
+/* global functions ========================================================= */
+
+int main(int argc, char** argv);
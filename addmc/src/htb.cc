@@ -173,16 +173,43 @@ JoinNonterminal* JoinRootBuilder::buildRoot(Int varOrderHeuristic, string cluste
     }
   }
 
-  if (verboseSolving >= 2) {
-    cout << "c building outer component: started\n";
+  if (!componentDecomposition) {
+    if (verboseSolving >= 2) {
+      cout << "c building outer component: started\n";
+    }
+    JoinComponent outerComponent(varOrderHeuristic, clusteringHeuristic, nonterminals, Set<Int>());
+    JoinNonterminal* outerRoot = outerComponent.getComponentRoot();
+    if (verboseSolving >= 2) {
+      cout << "c building outer component: ended\n";
+    }
+
+    return outerRoot;
   }
-  JoinComponent outerComponent(varOrderHeuristic, clusteringHeuristic, nonterminals, Set<Int>());
-  JoinNonterminal* outerRoot = outerComponent.getComponentRoot();
-  if (verboseSolving >= 2) {
-    cout << "c building outer component: ended\n";
+
+  vector<Int> varComponents = JoinNode::cnf.getVarComponents();
+  map<Int, vector<JoinNode*>> componentNonterminals; // representative var |-> inner roots; ordered for deterministic join trees
+  for (Int i = 0; i < nonterminals.size(); i++) {
+    Int clauseIndex = clauseGroups.at(i).front(); // clause group lies in one connected component
+    Int var = abs(*JoinNode::cnf.clauses.at(clauseIndex).begin());
+    componentNonterminals[varComponents.at(var)].push_back(nonterminals.at(i));
   }
 
-  return outerRoot;
+  vector<JoinNode*> componentRoots; // children of root share no var, so executor can solve them separately
+  for (const auto& [representative, componentChildren] : componentNonterminals) {
+    if (verboseSolving >= 2) {
+      cout << "c building outer component of var " << representative << ": started\n";
+    }
+    JoinComponent outerComponent(varOrderHeuristic, clusteringHeuristic, componentChildren, Set<Int>());
+    componentRoots.push_back(outerComponent.getComponentRoot());
+    if (verboseSolving >= 2) {
+      cout << "c building outer component of var " << representative << ": ended\n";
+    }
+  }
+  if (verboseSolving >= 1) {
+    util::printRow("componentCount", componentRoots.size());
+  }
+
+  return new JoinNonterminal(componentRoots);
 }
 
 JoinRootBuilder::JoinRootBuilder() {
@@ -198,20 +225,53 @@ JoinRootBuilder::JoinRootBuilder() {
 /* class Planner ============================================================ */
 
 void Planner::printJoinTree() const {
+  if (joinTreeFormat == BINARY_FORMAT) {
+    printBinaryJoinTree();
+    return;
+  }
+
   cout << "p " << JOIN_TREE_WORD << " " << JoinNode::cnf.declaredVarCount << " " << joinRoot->terminalCount << " " << joinRoot->nodeCount << "\n";
   joinRoot->printSubtree();
 }
 
+void Planner::printBinaryJoinTree() const {
+  string bytes;
+  util::appendVarint(bytes, JoinNode::cnf.declaredVarCount);
+  util::appendVarint(bytes, joinRoot->terminalCount);
+  util::appendVarint(bytes, joinRoot->nodeCount);
+  joinRoot->appendSubtreeBytes(bytes);
+
+  cout << BINARY_FRAME_WORD << " " << bytes.size() << "\n";
+  cout.write(bytes.data(), bytes.size());
+  cout << "\n";
+}
+
 void Planner::outputJoinTree() {
+  JoinTreeCache joinTreeCache(JoinNode::cnf);
+  if (joinTreeCache.hasJoinTree()) { // LG-style separator lets dmc replace cached join tree with narrower one
+    cout << DASH_LINE;
+    joinTreeCache.printJoinTree();
+    cout << DASH_LINE;
+    cout << "=\n";
+  }
+
   cout << "c computing output...\n";
 
   setJoinTree();
+  Int width = joinRoot->getWidth();
+
+  if (width >= joinTreeCache.cachedWidth) {
+    cout << "c kept cached join tree, which is at most as wide as new join tree of width " << width << "\n";
+    return;
+  }
 
   cout << DASH_LINE;
   printJoinTree();
   cout << DASH_LINE;
 
-  util::printRow("joinTreeWidth", joinRoot->getWidth());
+  util::printRow("joinTreeWidth", width);
+
+  joinTreeCache.storeJoinTree(joinRoot, JoinNode::cnf.declaredVarCount, joinRoot->terminalCount, joinRoot->nodeCount, width, util::getDuration(toolStartPoint));
 }
 
 /* class BucketElimPlanner ================================================== */
@@ -220,9 +280,10 @@ void BucketElimPlanner::setJoinTree() {
   joinRoot = JoinRootBuilder().buildRoot(clusterVarOrderHeuristic, usingTreeClustering ? BUCKET_ELIM_TREE : BUCKET_ELIM_LIST);
 }
 
-BucketElimPlanner::BucketElimPlanner(bool usingTreeClustering, Int clusterVarOrderHeuristic) {
+BucketElimPlanner::BucketElimPlanner(bool usingTreeClustering, Int clusterVarOrderHeuristic, string joinTreeFormat) {
   this->usingTreeClustering = usingTreeClustering;
   this->clusterVarOrderHeuristic = clusterVarOrderHeuristic;
+  this->joinTreeFormat = joinTreeFormat;
 }
 
 /* class BouquetMethodPlanner =============================================== */
@@ -231,9 +292,10 @@ void BouquetMethodPlanner::setJoinTree() {
   joinRoot = JoinRootBuilder().buildRoot(clusterVarOrderHeuristic, usingTreeClustering ? BOUQUET_METHOD_TREE : BOUQUET_METHOD_LIST);
 }
 
-BouquetMethodPlanner::BouquetMethodPlanner(bool usingTreeClustering, Int clusterVarOrderHeuristic) {
+BouquetMethodPlanner::BouquetMethodPlanner(bool usingTreeClustering, Int clusterVarOrderHeuristic, string joinTreeFormat) {
   this->usingTreeClustering = usingTreeClustering;
   this->clusterVarOrderHeuristic = clusterVarOrderHeuristic;
+  this->joinTreeFormat = joinTreeFormat;
 }
 
 /* class OptionDict ========================================================= */
@@ -249,6 +311,17 @@ string OptionDict::helpClusteringHeuristic() {
   return s + "; string";
 }
 
+string OptionDict::helpJoinTreeFormat() {
+  string s = "join tree format: ";
+  for (auto it = JOIN_TREE_FORMATS.begin(); it != JOIN_TREE_FORMATS.end(); it++) {
+    s += it->first + "/" + it->second;
+    if (next(it) != JOIN_TREE_FORMATS.end()) {
+      s += ", ";
+    }
+  }
+  return s + "; string";
+}
+
 void OptionDict::runCommand() const {
   if (verboseSolving >= 1) {
     cout << "c processing command-line options...\n";
@@ -257,30 +330,43 @@ void OptionDict::runCommand() const {
     util::printRow("randomSeed", randomSeed);
     util::printRow("clusterVarOrderHeuristic", (clusterVarOrderHeuristic < 0 ? "INVERSE_" : "") + CNF_VAR_ORDER_HEURISTICS.at(abs(clusterVarOrderHeuristic)));
     util::printRow("clusteringHeuristic", CLUSTERING_HEURISTICS.at(clusteringHeuristic));
+    util::printRow("joinTreeFormat", JOIN_TREE_FORMATS.at(joinTreeFormat));
+    if (!joinTreeCacheDir.empty()) {
+      util::printRow("joinTreeCacheDir", joinTreeCacheDir);
+    }
+    util::printRow("xorElimination", xorElimination);
+    util::printRow("preprocessing", preprocessing);
+    util::printRow("componentDecomposition", componentDecomposition);
+    if (!formulaOutputPath.empty()) {
+      util::printRow("formulaOutputFile", formulaOutputPath);
+    }
     cout << "\n";
   }
 
   try {
     JoinNode::cnf = Cnf(cnfFilePath);
+    if (!formulaOutputPath.empty()) { // e.g., for LG
+      JoinNode::cnf.writeFile(formulaOutputPath);
+    }
     if (clusteringHeuristic == BUCKET_ELIM_LIST) {
-      BucketElimPlanner bucketElimPlanner(false, clusterVarOrderHeuristic);
+      BucketElimPlanner bucketElimPlanner(false, clusterVarOrderHeuristic, joinTreeFormat);
       bucketElimPlanner.outputJoinTree();
     }
     else if (clusteringHeuristic == BUCKET_ELIM_TREE) {
-      BucketElimPlanner bucketElimPlanner(true, clusterVarOrderHeuristic);
+      BucketElimPlanner bucketElimPlanner(true, clusterVarOrderHeuristic, joinTreeFormat);
       bucketElimPlanner.outputJoinTree();
     }
     else if (clusteringHeuristic == BOUQUET_METHOD_LIST) {
-      BouquetMethodPlanner bouquetMethodPlanner(false, clusterVarOrderHeuristic);
+      BouquetMethodPlanner bouquetMethodPlanner(false, clusterVarOrderHeuristic, joinTreeFormat);
       bouquetMethodPlanner.outputJoinTree();
     }
     else {
       assert(clusteringHeuristic == BOUQUET_METHOD_TREE);
-      BouquetMethodPlanner bouquetMethodPlanner(true, clusterVarOrderHeuristic);
+      BouquetMethodPlanner bouquetMethodPlanner(true, clusterVarOrderHeuristic, joinTreeFormat);
       bouquetMethodPlanner.outputJoinTree();
     }
   }
-  catch (EmptyClauseException) {}
+  catch (UnsatException) {}
 }
 
 OptionDict::OptionDict(int argc, char** argv) {
@@ -292,6 +378,12 @@ OptionDict::OptionDict(int argc, char** argv) {
     (RANDOM_SEED_OPTION, "random seed; int", value<Int>()->default_value("0"))
     (CLUSTER_VAR_OPTION, util::helpVarOrderHeuristic("cluster"), value<Int>()->default_value(to_string(LEX_P)))
     (CLUSTERING_HEURISTIC_OPTION, helpClusteringHeuristic(), value<string>()->default_value(BOUQUET_METHOD_TREE))
+    (JOIN_TREE_FORMAT_OPTION, helpJoinTreeFormat(), value<string>()->default_value(TEXT_FORMAT))
+    (JOIN_TREE_CACHE_OPTION, "join tree cache dir (empty for no cache); string", value<string>()->default_value(""))
+    (XOR_ELIMINATION_OPTION, "Gaussian elimination over XOR clauses: 0, 1; int", value<Int>()->default_value("0"))
+    (PREPROCESSING_OPTION, "preprocessing (units, equivalent literals, subsumed clauses): 0, 1; int", value<Int>()->default_value("0"))
+    (COMPONENT_DECOMPOSITION_OPTION, "component decomposition (one subtree per connected component under root): 0, 1; int", value<Int>()->default_value("0"))
+    (FORMULA_OUTPUT_OPTION, "output file for (preprocessed) CNF formula (empty for no output); string", value<string>()->default_value(""))
     (VERBOSE_CNF_OPTION, "verbose CNF processing: " + INPUT_VERBOSITY_LEVELS, value<Int>()->default_value("0"))
     (VERBOSE_SOLVING_OPTION, util::helpVerboseSolving(), value<Int>()->default_value("1"))
   ;
@@ -312,6 +404,20 @@ OptionDict::OptionDict(int argc, char** argv) {
     clusteringHeuristic = result[CLUSTERING_HEURISTIC_OPTION].as<string>();
     assert(CLUSTERING_HEURISTICS.contains(clusteringHeuristic));
 
+    joinTreeFormat = result[JOIN_TREE_FORMAT_OPTION].as<string>();
+    assert(JOIN_TREE_FORMATS.contains(joinTreeFormat));
+
+    joinTreeCacheDir = result[JOIN_TREE_CACHE_OPTION].as<string>(); // global var
+
+    xorElimination = result[XOR_ELIMINATION_OPTION].as<Int>(); // global var
+
+    preprocessing = result[PREPROCESSING_OPTION].as<Int>(); // global var
+
+    componentDecomposition = result[COMPONENT_DECOMPOSITION_OPTION].as<Int>(); // global var
+
+    formulaOutputPath = result[FORMULA_OUTPUT_OPTION].as<string>();
+    weightedCounting = !formulaOutputPath.empty(); // global var; weights are only copied to output formula
+
     verboseCnf = result[VERBOSE_CNF_OPTION].as<Int>(); // global var
 
     verboseSolving = result[VERBOSE_SOLVING_OPTION].as<Int>(); // global var
@@ -16,6 +16,16 @@ using cxxopts::value;
 
 const string CLUSTER_VAR_OPTION = "cv";
 const string CLUSTERING_HEURISTIC_OPTION = "ch";
+const string JOIN_TREE_FORMAT_OPTION = "jf";
+const string FORMULA_OUTPUT_OPTION = "fo";
+
+/* join tree formats: */
+const string TEXT_FORMAT = "t";
+const string BINARY_FORMAT = "b";
+const map<string, string> JOIN_TREE_FORMATS = {
+  {TEXT_FORMAT, "TEXT"},
+  {BINARY_FORMAT, "BINARY"}
+};
 
 /* classes for planning ===================================================== */
 
@@ -65,8 +75,10 @@ public:
 
   bool usingTreeClustering; // as opposed to list clustering
   Int clusterVarOrderHeuristic;
+  string joinTreeFormat;
 
   void printJoinTree() const;
+  void printBinaryJoinTree() const; // single length-prefixed frame
   void outputJoinTree();
 
   virtual void setJoinTree() = 0;
@@ -76,14 +88,14 @@ class BucketElimPlanner : public Planner {
 public:
   void setJoinTree() override;
 
-  BucketElimPlanner(bool usingTreeClustering, Int clusterVarOrderHeuristic);
+  BucketElimPlanner(bool usingTreeClustering, Int clusterVarOrderHeuristic, string joinTreeFormat);
 };
 
 class BouquetMethodPlanner : public Planner { // Bouquet's Method
 public:
   void setJoinTree() override;
 
-  BouquetMethodPlanner(bool usingTreeClustering, Int clusterVarOrderHeuristic);
+  BouquetMethodPlanner(bool usingTreeClustering, Int clusterVarOrderHeuristic, string joinTreeFormat);
 };
 
 class OptionDict {
@@ -91,8 +103,11 @@ public:
   string cnfFilePath;
   Int clusterVarOrderHeuristic;
   string clusteringHeuristic;
+  string joinTreeFormat;
+  string formulaOutputPath; // empty: no output formula
 
   string helpClusteringHeuristic();
+  string helpJoinTreeFormat();
   void runCommand() const;
 
   OptionDict(int argc, char** argv);
@@ -0,0 +1,55 @@
+/* test: LG and htb/dmc compute the same join tree cache key for the same CNF, with or without projected counting */
+
+/* inclusions =============================================================== */
+
+#include "../src/common.hh"
+
+#include "util/formula.h" // LG
+#include "util/join_tree_cache.h" // LG
+
+/* consts =================================================================== */
+
+const string CNF_TEXT = // show line, XOR clause, duplicate literal, hidden var 6
+  "p cnf 6 4\n"
+  "c p show 4 1 2 0\n"
+  "c p weight 1 0.3 0\n"
+  "1 -2 0\n"
+  "2 3 3 -4 0\n"
+  "x 1 4 5 0\n"
+  "-5 2 0\n";
+
+/* global functions ========================================================= */
+
+string getLgKey(string cnfText) {
+  std::istringstream inputStream(cnfText);
+  std::optional<util::Formula> formula = util::Formula::parse_DIMACS(&inputStream);
+  if (!formula.has_value()) {
+    throw MyError("LG cannot parse test CNF");
+  }
+  return util::JoinTreeCache::structure_key(*formula);
+}
+
+string getAddmcKey(string cnfFilePath, bool projectedFlag) {
+  projectedCounting = projectedFlag; // global vars read by Cnf
+  weightedCounting = true;
+  verboseCnf = 0;
+  return JoinTreeCache::getStructureKey(Cnf(cnfFilePath));
+}
+
+int main() { // run from addmc/ via `make test`; exits with 1 if keys differ
+  string cnfFilePath = std::filesystem::temp_directory_path() / ("cache_key_" + to_string(getpid()) + ".cnf");
+  std::ofstream(cnfFilePath) << CNF_TEXT;
+
+  string lgKey = getLgKey(CNF_TEXT);
+  bool passedFlag = true;
+  for (bool projectedFlag : {false, true}) {
+    string addmcKey = getAddmcKey(cnfFilePath, projectedFlag);
+    bool sameFlag = addmcKey == lgKey;
+    cout << "c projectedCounting " << projectedFlag << ": LG key " << lgKey << ", addmc key " << addmcKey << (sameFlag ? "" : " (MISMATCH)") << "\n";
+    passedFlag = passedFlag && sameFlag;
+  }
+  std::remove(cnfFilePath.c_str());
+
+  cout << "c cache key test " << (passedFlag ? "passed" : "FAILED") << "\n";
+  return passedFlag ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# test: memory governor with small --mm ends quickly, by re-slicing or with MyError, instead of re-slicing ancestors exponentially
+# run from addmc/ via `make test`; exits with 1 if a run times out or gives an unexpected result
+
+CNF_FILE=../examples/chain_n100_k10.xcnf
+SOLVE_OPTIONS="--wc=1 --er=1 --lc=1 --mg=0.5"
+TIMEOUT_SECONDS=60
+SOLUTION=183.000000000000000000
+
+passedFlag=1
+check() { # max mem, expected result, min reslicedSubtreeCount
+  output=$(./htb --cf=$CNF_FILE | timeout $TIMEOUT_SECONDS ./dmc --cf=$CNF_FILE $SOLVE_OPTIONS --mm=$1 2>&1)
+  if [[ $? == 124 ]]; then
+    result="TIMEOUT"
+  elif grep -q "MY_ERROR: memory governor" <<< "$output"; then
+    result="MyError"
+  else
+    result=$(grep "log10-estimate" <<< "$output" | awk '{print $4}')
+  fi
+  reslicedCount=$(grep "reslicedSubtreeCount" <<< "$output" | awk '{print $3}')
+  echo "c --mm=$1: $result, reslicedSubtreeCount ${reslicedCount:-none} (expected $2, at least $3)"
+  if [[ $result != $2 || ${reslicedCount:-0} -lt $3 ]]; then
+    passedFlag=0
+  fi
+}
+
+check 5 $SOLUTION 0 # fits
+check 0.2 $SOLUTION 1 # re-slices
+check 0.02 MyError 0 # cannot fit
+
+if [[ $passedFlag == 1 ]]; then
+  echo "c governor test passed"
+  exit 0
+fi
+echo "c governor test FAILED"
+exit 1
@@ -5,11 +5,13 @@ Copyright (c) 2020, Jeffrey Dudek
 #include "decomposition/join_tree.h"
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <numeric>
 #include <unordered_set>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace decomposition {
@@ -182,11 +184,11 @@ void JoinTree::compute_projected_variables(const util::Formula &formula) {
   }
 }
 
-void JoinTree::write(std::ostream *output) const {
+size_t JoinTree::count_output_nodes() const {
   // The .jt format uses dummy nodes if clauses have projected variables.
   // Compute the total number of nodes in the tree including these dummy nodes.
-  size_t num_nodes = visit<size_t>([&](const JoinTreeNode &node,
-                                       std::vector<size_t> children) {
+  return visit<size_t>([&](const JoinTreeNode &node,
+                           std::vector<size_t> children) {
     if (children.size() == 0) {
       if (node.projected_variables.size() == 0) {
         return static_cast<size_t>(1);
@@ -203,15 +205,9 @@ void JoinTree::write(std::ostream *output) const {
     }
     return result;
   });
+}
 
-  // Write the join tree header
-  *output << "p jt";
-  *output << " " << highest_projected_var_;
-  *output << " " << highest_leaf_id_+1;
-  *output << " " << num_nodes;
-  *output << "\n";
-
-  // Print out all internal nodes
+void JoinTree::visit_output_nodes(const OutputNodeVisitor &visitor) const {
   size_t next_id = highest_leaf_id_+2;
   visit<size_t>([&](const JoinTreeNode &node,
                  std::vector<size_t> children) {
@@ -228,23 +224,81 @@ void JoinTree::write(std::ostream *output) const {
       children.push_back(node.clause_id+1);
     }  // Fall-through
 
-    *output << next_id;
+    visitor(next_id, children, node.projected_variables);
+    next_id++;
+    return next_id-1;
+  });
+}
+
+void JoinTree::write(std::ostream *output) const {
+  // Write the join tree header
+  *output << "p jt";
+  *output << " " << highest_projected_var_;
+  *output << " " << highest_leaf_id_+1;
+  *output << " " << count_output_nodes();
+  *output << "\n";
+
+  // Print out all internal nodes
+  visit_output_nodes([&](size_t id, const std::vector<size_t> &children,
+                         const std::vector<size_t> &projected_variables) {
+    *output << id;
     for (size_t child : children) {
       *output << " " << child;
     }
     *output << " e";
-    for (size_t projected : node.projected_variables) {
+    for (size_t projected : projected_variables) {
       *output << " " << projected;
     }
     *output << "\n";
-    next_id++;
-    return next_id-1;
   });
 
   // Print out the join tree width
   *output << "c joinTreeWidth " << width_ << "\n";
 }
 
+namespace {
+/**
+ * Append [value] to [bytes] as an unsigned LEB128 varint.
+ */
+void append_varint(std::string *bytes, size_t value) {
+  while (value >= 0x80) {
+    bytes->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  bytes->push_back(static_cast<char>(value));
+}
+}  // namespace
+
+void JoinTree::write_binary(std::ostream *output) const {
+  // The payload holds the header and then every internal node as:
+  // index, child count, children, variable count, variables.
+  std::string bytes;
+  append_varint(&bytes, highest_projected_var_);
+  append_varint(&bytes, highest_leaf_id_+1);
+  append_varint(&bytes, count_output_nodes());
+
+  visit_output_nodes([&](size_t id, const std::vector<size_t> &children,
+                         const std::vector<size_t> &projected_variables) {
+    append_varint(&bytes, id);
+    append_varint(&bytes, children.size());
+    for (size_t child : children) {
+      append_varint(&bytes, child);
+    }
+    append_varint(&bytes, projected_variables.size());
+    for (size_t projected : projected_variables) {
+      append_varint(&bytes, projected);
+    }
+  });
+
+  // Write the length-prefixed frame
+  *output << "b " << bytes.size() << "\n";
+  output->write(bytes.data(), bytes.size());
+  *output << "\n";
+
+  // Print out the join tree width
+  *output << "c joinTreeWidth " << width_ << "\n";
+}
+
 void JoinTree::compute_width(const util::Formula &formula) {
   width_ = 0;
   visit<std::vector<size_t>>([&] (const JoinTreeNode &node,
@@ -4,6 +4,7 @@ Copyright (c) 2020, Jeffrey Dudek
 
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include "decomposition/tree.h"
@@ -54,6 +55,12 @@ class JoinTree {
    */
   void write(std::ostream *output) const;
 
+  /**
+   * Output the join tree as a single length-prefixed binary frame:
+   * a "b [BYTES]" line, then [BYTES] bytes of varints, then a newline.
+   */
+  void write_binary(std::ostream *output) const;
+
   /**
    * Add a leaf to the join tree.
    */
@@ -79,6 +86,13 @@ class JoinTree {
    */
   void compute_width(const util::Formula &formula);
 
+  /**
+   * Get the width computed by compute_width.
+   */
+  size_t width() const {
+    return width_;
+  }
+
   /**
    * Set the root of the join tree.
    */
@@ -99,6 +113,21 @@ class JoinTree {
     const decomposition::TreeDecomposition &tree_decomposition);
 
  private:
+  typedef std::function<void(size_t, const std::vector<size_t> &,
+                             const std::vector<size_t> &)> OutputNodeVisitor;
+
+  /**
+   * Count the nodes in the output, including dummy nodes for projections at
+   * leaves but excluding skipped nodes with 1 child and 0 projections.
+   */
+  size_t count_output_nodes() const;
+
+  /**
+   * Runs "visitor" on every output internal node in postorder with its
+   * 1-indexed id, the ids of its children, and its projected variables.
+   */
+  void visit_output_nodes(const OutputNodeVisitor &visitor) const;
+
   size_t root_;
   size_t highest_leaf_id_;
   size_t highest_projected_var_;
@@ -5,9 +5,16 @@ Copyright (c) 2020, Jeffrey Dudek
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <string>
+
 #include "util/dimacs_parser.h"
 #include "util/formula.h"
 #include "util/graded_clauses.h"
+#include "util/join_tree_cache.h"
 #include "decomposition/tree_decomposition.h"
 #include "decomposition/join_tree.h"
 
@@ -17,13 +24,32 @@ int main(int argc, char *argv[]) {
   // Print help message
   if (argc == 2 &&
       (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)) {
-      std::cout << argv[0] << " [TREE DECOMPOSER]" << std::endl;
+      std::cout << argv[0] << " [-b] [-c CACHE DIR] [TREE DECOMPOSER]" << std::endl;
       std::cout << "    Use [TREE DECOMPOSER] to make join trees." << std::endl;
       std::cout << "    Input formula is parsed from STDIN." << std::endl;
       std::cout << "    Join trees are written to STDOUT." << std::endl;
+      std::cout << "    -b: write join trees as binary frames." << std::endl;
+      std::cout << "    -c: first write the join tree cached in [CACHE DIR], then only narrower join trees (which are cached)." << std::endl;
       return 0;
   }
 
+  // Optional flags before the tree decomposer.
+  bool binary = false;
+  std::string cache_dir;
+  while (argc > 2) {
+    if (strcmp(argv[1], "-b") == 0) {
+      binary = true;
+    } else if (strcmp(argv[1], "-c") == 0 && argc > 3) {
+      cache_dir = argv[2];
+      argc--;
+      argv++;
+    } else {
+      break;
+    }
+    argc--;
+    argv++;
+  }
+
   if (argc != 2) {
     std::cerr << "Error: Exactly 1 argument required." << std::endl;
     return -1;
@@ -49,6 +75,16 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
+    // Start from the cached join tree, if any.
+    std::optional<util::JoinTreeCache> cache;
+    if (!cache_dir.empty()) {
+      cache.emplace(cache_dir, *f);
+      if (cache->has_join_tree()) {
+        cache->write(&std::cout);
+        std::cout << "=" << std::endl;
+      }
+    }
+
     // Provide the line graph of the input formula to the solver.
     util::GradedClauses clauses = f->graded_clauses();
     clauses.write_line_graph(&solver_input, f->num_variables());
@@ -73,11 +109,21 @@ int main(int argc, char *argv[]) {
         return -1;
       }
 
-      // Output the join tree to stdout.
-      jt->write(&std::cout);
-
       auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
         std::chrono::steady_clock::now() - start_time).count();
+
+      // Skip join trees that are no narrower than the cached one.
+      if (cache.has_value() && !cache->store(*jt, elapsed)) {
+        continue;
+      }
+
+      // Output the join tree to stdout.
+      if (binary) {
+        jt->write_binary(&std::cout);
+      } else {
+        jt->write(&std::cout);
+      }
+
       std::cout << "c seconds " << elapsed << "\n";
       std::cout << "=" << std::endl;
     }
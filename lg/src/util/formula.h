@@ -42,6 +42,13 @@ class Formula {
     return clause_variables_;
   }
 
+  /**
+   * Get the relevant (additive) variables, in the order they were parsed.
+   */
+  const std::vector<size_t> &relevant_vars() const {
+    return relevant_vars_;
+  }
+
   /*
   * Parses a file in DIMACS format into a boolean formula.
   *
@@ -0,0 +1,93 @@
+/******************************************
+Copyright (c) 2020, Jeffrey Dudek
+******************************************/
+
+#include "util/join_tree_cache.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace util {
+JoinTreeCache::JoinTreeCache(const std::string &directory,
+                             const Formula &formula)
+  : cached_width_(std::numeric_limits<size_t>::max()) {
+  std::filesystem::create_directories(directory);
+  path_ = (std::filesystem::path(directory) /
+           (structure_key(formula) + ".jt")).string();
+
+  // Find the width of the cached join tree, if any.
+  std::ifstream input(path_);
+  std::string line;
+  while (std::getline(input, line)) {
+    std::istringstream words(line);
+    std::string c, key;
+    size_t value;
+    if (words >> c >> key >> value && c == "c" && key == "joinTreeWidth") {
+      cached_width_ = value;
+    }
+  }
+}
+
+void JoinTreeCache::write(std::ostream *output) const {
+  std::ifstream input(path_);
+  *output << input.rdbuf();
+}
+
+bool JoinTreeCache::store(const decomposition::JoinTree &jt, double seconds) {
+  if (jt.width() >= cached_width_) {
+    return false;
+  }
+
+  // Write to a temporary file first so that readers never see partial trees.
+  std::string temp_path = path_ + ".tmp" + std::to_string(getpid());
+  std::ofstream output(temp_path);
+  jt.write(&output);
+  output << "c seconds " << seconds << "\n";
+  output.close();
+
+  if (!output || std::rename(temp_path.c_str(), path_.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  cached_width_ = jt.width();
+  return true;
+}
+
+std::string JoinTreeCache::structure_key(const Formula &formula) {
+  // The canonical text must match dmc and htb (addmc/src/common.cc).
+  std::string text = std::to_string(formula.num_variables()) + " " +
+    std::to_string(formula.clause_variables().size()) + "\n";
+  for (const std::vector<size_t> &vars : formula.clause_variables()) {
+    for (size_t var : vars) {  // Already sorted and unique
+      text += std::to_string(var) + " ";
+    }
+    text += "0\n";
+  }
+
+  std::vector<size_t> relevant_vars = formula.relevant_vars();
+  std::sort(relevant_vars.begin(), relevant_vars.end());
+  relevant_vars.erase(std::unique(relevant_vars.begin(), relevant_vars.end()),
+                      relevant_vars.end());
+  for (size_t var : relevant_vars) {
+    text += std::to_string(var) + " ";
+  }
+  text += "0\n";
+
+  uint64_t hash = 14695981039346656037ull;  // FNV-1a offset basis
+  for (unsigned char byte : text) {
+    hash ^= byte;
+    hash *= 1099511628211ull;  // FNV prime
+  }
+
+  std::ostringstream key;
+  key << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return key.str();
+}
+}  // namespace util
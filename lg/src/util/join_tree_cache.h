@@ -0,0 +1,62 @@
+/******************************************
+Copyright (c) 2020, Jeffrey Dudek
+******************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+
+#include "decomposition/join_tree.h"
+#include "util/formula.h"
+
+namespace util {
+/**
+ * An on-disk cache of join trees, shared with htb and dmc.
+ *
+ * Each formula maps to the file [DIR]/[KEY].jt, where [KEY] is the FNV-1a
+ * hash of the clause variables and relevant variables (weights are ignored).
+ * The file holds the narrowest known join tree in text format, followed by
+ * "c joinTreeWidth" and "c seconds" lines.
+ */
+class JoinTreeCache {
+ public:
+  JoinTreeCache(const std::string &directory, const Formula &formula);
+
+  /**
+   * Returns true if a join tree for this formula is cached.
+   */
+  bool has_join_tree() const {
+    return cached_width_ != std::numeric_limits<size_t>::max();
+  }
+
+  /**
+   * Returns the width of the cached join tree (SIZE_MAX if none).
+   */
+  size_t cached_width() const {
+    return cached_width_;
+  }
+
+  /**
+   * Copy the cached join tree (with its comment lines) to [output].
+   */
+  void write(std::ostream *output) const;
+
+  /**
+   * Replace the cached join tree if [jt] is narrower.
+   * Returns true if the cache was updated.
+   */
+  bool store(const decomposition::JoinTree &jt, double seconds);
+
+  /**
+   * Compute the cache key of a formula as 16 hexadecimal digits.
+   */
+  static std::string structure_key(const Formula &formula);
+
+ private:
+  std::string path_;
+  size_t cached_width_;
+};
+}  // namespace util